@@ -71,6 +71,10 @@ extern "C" {
 #include "adc.h"
 #include "pwm.h"
 #include "silabs_additional.h"
+#include "fast_gpio.h"
+#include "gpio_events.h"
+#include "input_capture.h"
+#include "debouncer.h"
 
 #include "overloads.h"
 
@@ -100,6 +104,95 @@ using std::abs;
  ******************************************************************************/
 void analogReferenceDAC(uint8_t reference);
 
+/***************************************************************************//**
+ * Measures multiple analog pins in one hardware scan sequence
+ * Faster than calling analogRead() for each pin, as the ADC converts the pins
+ * back-to-back without reconfiguration.
+ *
+ * @param[in] pins The pins to measure (at most 16)
+ * @param[in] num_pins The number of pins
+ * @param[out] results The measured values in the order of 'pins'
+ *
+ * @return true if the measurement was successful, false otherwise
+ ******************************************************************************/
+bool analogReadMulti(const pin_size_t* pins, uint8_t num_pins, uint16_t* results);
+bool analogReadMulti(const PinName* pins, uint8_t num_pins, uint16_t* results);
+
+/***************************************************************************//**
+ * Starts measuring an analog pin and returns without waiting for the result
+ * The conversion completes in the background - the result is either handed
+ * to the callback after loop() returns, or can be polled with
+ * analogReadAsyncReady() and read with analogReadAsyncResult().
+ *
+ * @param[in] pin The pin to measure
+ * @param[in] callback Called with the result - nullptr to poll for it
+ *
+ * @return true if the measurement was started, false if the ADC is busy
+ ******************************************************************************/
+bool analogReadAsync(pin_size_t pin, adc_read_callback_t callback = nullptr);
+bool analogReadAsync(PinName pin, adc_read_callback_t callback = nullptr);
+
+/***************************************************************************//**
+ * Returns whether the result of analogReadAsync() is ready
+ *
+ * @return true if the result is ready, false otherwise
+ ******************************************************************************/
+bool analogReadAsyncReady();
+
+/***************************************************************************//**
+ * Returns the result of the last analogReadAsync() measurement
+ *
+ * @return the measured value
+ ******************************************************************************/
+int analogReadAsyncResult();
+
+/***************************************************************************//**
+ * Appends a note to the melody playing in the background
+ * Starts playing right away if no melody is playing. Notes can only be added
+ * to the pin which is currently playing. Frequencies from 65535 Hz down to
+ * about 1 Hz can be played - notes out of this range are rejected.
+ *
+ * @param[in] pin The output pin
+ * @param[in] frequency The frequency of the note in hertz (1 - 65535) - 0 for a rest
+ * @param[in] duration The duration of the note in milliseconds
+ *
+ * @return true if the note was queued, false if the queue is full,
+ *         an other pin is playing or the frequency is out of range
+ ******************************************************************************/
+bool toneQueue(pin_size_t pin, unsigned int frequency, unsigned long duration);
+bool toneQueue(PinName pin, unsigned int frequency, unsigned long duration);
+
+/***************************************************************************//**
+ * Plays a sequence of notes in the background
+ * The notes are appended to the melody playing on the pin. Queueing stops at
+ * the first note which doesn't fit into the queue (TONE_QUEUE_SIZE) or has a
+ * frequency out of the range of toneQueue() - the rest is not played.
+ *
+ * @param[in] pin The output pin
+ * @param[in] notes The notes to play
+ * @param[in] num_notes The number of notes
+ *
+ * @return the number of notes queued
+ ******************************************************************************/
+size_t playMelody(pin_size_t pin, const tone_note_t* notes, size_t num_notes);
+size_t playMelody(PinName pin, const tone_note_t* notes, size_t num_notes);
+
+/***************************************************************************//**
+ * Returns whether a tone with a duration or a melody is playing
+ *
+ * @return true if a note is playing, false otherwise
+ ******************************************************************************/
+bool isTonePlaying();
+
+/***************************************************************************//**
+ * Sets the resolution of the values returned by analogRead()
+ * Resolutions above 12 bits need hardware oversampling to carry information -
+ * see ADC.set_oversampling() and ADC.set_high_accuracy_mode().
+ *
+ * @param[in] resolution The requested resolution in bits (1-16)
+ ******************************************************************************/
+void analogReadResolution(int resolution);
+
 typedef enum _dac_channel_t dac_channel_t;
 void analogWrite(dac_channel_t dac_channel, int value);
 void analogWriteResolution(int resolution);
@@ -108,4 +201,23 @@ bool get_system_init_finished();
 uint32_t get_system_reset_cause();
 void escape_hatch();
 
+// Maximum number of functions which can be registered with register_arduino_task_hook()
+#ifndef ARDUINO_TASK_HOOKS_MAX
+#define ARDUINO_TASK_HOOKS_MAX 8
+#endif // ARDUINO_TASK_HOOKS_MAX
+
+typedef void (*arduino_task_hook_t)();
+
+/***************************************************************************//**
+ * Registers a function to be called from the Arduino task after each loop()
+ * The subsystems which deliver callbacks from the Arduino task register their
+ * hook when they're first used - the ones a sketch doesn't use are left out
+ * at link time. Registering the same function again has no effect.
+ *
+ * @param[in] hook The function to call
+ *
+ * @return true if the hook is registered, false if there's no more room for it
+ ******************************************************************************/
+bool register_arduino_task_hook(arduino_task_hook_t hook);
+
 #endif // ARDUINO_H
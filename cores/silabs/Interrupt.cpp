@@ -27,81 +27,57 @@
 #include "Arduino.h"
 #include "pinDefinitions.h"
 
-#include <list>
 #include "gpiointerrupt.h"
+#include "gpio_events.h"
 
 typedef struct {
   PinName pin_name;
-  void (*callback)(void);
-  uint32_t interrupt_num;
+  voidFuncPtr callback;
+  voidFuncPtrParam callback_param;
+  void* param;
+  PinStatus mode;
+  bool deferred;
 } gpio_interrupt_handler_t;
 
-static std::list<gpio_interrupt_handler_t> gpio_interrupt_handlers;
+// Interrupt handlers indexed by the GPIOINT interrupt number allocated for the pin
+// Entries with an invalid pin name are free
+static gpio_interrupt_handler_t gpio_interrupt_handlers[GPIO_EXTINTNO_MAX + 1];
 
 static void gpio_irq_handler(uint8_t interrupt_num, void *ctx)
 {
   (void)ctx;
-  // Go through all the interrupt handler entries
-  for (auto& entry : gpio_interrupt_handlers) {
-    // If the entry matches the triggered interrupt number - call the registered callback
-    if (entry.interrupt_num == interrupt_num && entry.callback) {
-      entry.callback();
-    }
-  }
-}
-
-void detachInterrupt(PinName interruptNumber)
-{
-  bool entry_found = false;
-  uint8_t interrupt_num;
-  // Find the handler entry for the requested pin
-  for (auto it = gpio_interrupt_handlers.begin(); it != gpio_interrupt_handlers.end(); it++) {
-    // If found - remove it
-    if (it->pin_name == interruptNumber) {
-      interrupt_num = it->interrupt_num;
-      GPIOINT_CallbackUnRegister(interrupt_num);
-      entry_found = true;
-      gpio_interrupt_handlers.erase(it);
-      break;
-    }
-  }
-
-  // Return if the entry for the pin was not found
-  if (!entry_found) {
+  if (interrupt_num > GPIO_EXTINTNO_MAX) {
     return;
   }
-
-  // Deregister the external interrupt as well
-  GPIO_Port_TypeDef sl_port = getSilabsPortFromArduinoPin(interruptNumber);
-  uint32_t sl_pin = getSilabsPinFromArduinoPin(interruptNumber);
-  GPIO_ExtIntConfig(sl_port, sl_pin, interrupt_num, false, false, false);
-}
-
-void detachInterrupt(pin_size_t interruptNumber)
-{
-  PinName actual_pin = pinToPinName(interruptNumber);
-  if (actual_pin == PIN_NAME_NC) {
-    return;
+  // Call the callback registered for the triggered interrupt number
+  gpio_interrupt_handler_t* handler = &gpio_interrupt_handlers[interrupt_num];
+  if (handler->deferred) {
+    // Record the edge and defer the handling to the Arduino task
+    PinStatus edge = RISING;
+    if (handler->mode == FALLING || handler->mode == LOW) {
+      edge = FALLING;
+    } else if (handler->mode == CHANGE) {
+      GPIO_Port_TypeDef sl_port = getSilabsPortFromArduinoPin(handler->pin_name);
+      uint32_t sl_pin = getSilabsPinFromArduinoPin(handler->pin_name);
+      edge = GPIO_PinInGet(sl_port, sl_pin) ? RISING : FALLING;
+    }
+    gpio_event_post(handler->pin_name, edge);
+  } else if (handler->callback_param) {
+    handler->callback_param(handler->param);
+  } else if (handler->callback) {
+    handler->callback();
   }
-  detachInterrupt(actual_pin);
 }
 
-void attachInterruptParam(PinName interruptNumber, voidFuncPtrParam callback, PinStatus mode, void* param)
+static void attach_interrupt_handler(PinName pin_name, voidFuncPtr callback, voidFuncPtrParam callback_param, void* param, PinStatus mode, bool deferred)
 {
-  (void)interruptNumber;
-  (void)callback;
-  (void)mode;
-  (void)param;
-}
-
-void attachInterrupt(PinName interruptNumber, voidFuncPtr callback, PinStatus mode)
-{
-  if (interruptNumber >= PIN_NAME_MAX || callback == nullptr || mode < LOW || mode > RISING || !get_system_init_finished()) {
+  if (pin_name < PIN_NAME_MIN || pin_name >= PIN_NAME_MAX || (callback == nullptr && callback_param == nullptr && !deferred)
+      || mode < LOW || mode > RISING || !get_system_init_finished()) {
     return;
   }
 
-  GPIO_Port_TypeDef sl_port = getSilabsPortFromArduinoPin(interruptNumber);
-  uint32_t sl_pin = getSilabsPinFromArduinoPin(interruptNumber);
+  GPIO_Port_TypeDef sl_port = getSilabsPortFromArduinoPin(pin_name);
+  uint32_t sl_pin = getSilabsPinFromArduinoPin(pin_name);
 
   bool rising_edge = false;
   bool falling_edge = false;
@@ -124,29 +100,84 @@ void attachInterrupt(PinName interruptNumber, voidFuncPtr callback, PinStatus mo
       break;
   }
 
+  // Remove the previous handler if the pin already has one
+  detachInterrupt(pin_name);
+
   // Allocate an interrupt number for the pin
   uint32_t interrupt_num = GPIOINT_CallbackRegisterExt(sl_pin, &gpio_irq_handler, nullptr);
-  if (interrupt_num == INTERRUPT_UNAVAILABLE) {
+  if (interrupt_num == INTERRUPT_UNAVAILABLE || interrupt_num > GPIO_EXTINTNO_MAX) {
     return;
   }
 
+  // Register the GPIO interrupt handler before enabling the interrupt
+  gpio_interrupt_handlers[interrupt_num].pin_name = pin_name;
+  gpio_interrupt_handlers[interrupt_num].callback = callback;
+  gpio_interrupt_handlers[interrupt_num].callback_param = callback_param;
+  gpio_interrupt_handlers[interrupt_num].param = param;
+  gpio_interrupt_handlers[interrupt_num].mode = mode;
+  gpio_interrupt_handlers[interrupt_num].deferred = deferred;
+
   // Configure the external interrupt for the pin
   GPIO_ExtIntConfig(sl_port, sl_pin, interrupt_num, rising_edge, falling_edge, true);
+}
+
+void detachInterrupt(PinName interruptNumber)
+{
+  if (interruptNumber < PIN_NAME_MIN || interruptNumber >= PIN_NAME_MAX) {
+    return;
+  }
+
+  // Find the handler entry for the requested pin
+  uint8_t interrupt_num;
+  for (interrupt_num = 0; interrupt_num <= GPIO_EXTINTNO_MAX; interrupt_num++) {
+    if (gpio_interrupt_handlers[interrupt_num].pin_name == interruptNumber) {
+      break;
+    }
+  }
+
+  // Return if the entry for the pin was not found
+  if (interrupt_num > GPIO_EXTINTNO_MAX) {
+    return;
+  }
+
+  // Deregister the external interrupt and free the handler entry
+  GPIO_Port_TypeDef sl_port = getSilabsPortFromArduinoPin(interruptNumber);
+  uint32_t sl_pin = getSilabsPinFromArduinoPin(interruptNumber);
+  GPIO_ExtIntConfig(sl_port, sl_pin, interrupt_num, false, false, false);
+  GPIOINT_CallbackUnRegister(interrupt_num);
+  gpio_interrupt_handlers[interrupt_num].pin_name = PIN_NAME_NC;
+  gpio_interrupt_handlers[interrupt_num].callback = nullptr;
+  gpio_interrupt_handlers[interrupt_num].callback_param = nullptr;
+  gpio_interrupt_handlers[interrupt_num].param = nullptr;
+  gpio_interrupt_handlers[interrupt_num].deferred = false;
+}
+
+void detachInterrupt(pin_size_t interruptNumber)
+{
+  PinName actual_pin = pinToPinName(interruptNumber);
+  if (actual_pin == PIN_NAME_NC) {
+    return;
+  }
+  detachInterrupt(actual_pin);
+}
 
-  // Register the GPIO interrupt handler
-  gpio_interrupt_handler_t inthandler_entry;
-  inthandler_entry.pin_name = interruptNumber;
-  inthandler_entry.callback = callback;
-  inthandler_entry.interrupt_num = interrupt_num;
-  gpio_interrupt_handlers.push_back(inthandler_entry);
+void attachInterruptParam(PinName interruptNumber, voidFuncPtrParam callback, PinStatus mode, void* param)
+{
+  attach_interrupt_handler(interruptNumber, nullptr, callback, param, mode, false);
+}
+
+void attachInterrupt(PinName interruptNumber, voidFuncPtr callback, PinStatus mode)
+{
+  attach_interrupt_handler(interruptNumber, callback, nullptr, nullptr, mode, false);
 }
 
 void attachInterruptParam(pin_size_t interruptNumber, voidFuncPtrParam callback, PinStatus mode, void* param)
 {
-  (void)interruptNumber;
-  (void)callback;
-  (void)mode;
-  (void)param;
+  PinName pin_name = pinToPinName(interruptNumber);
+  if (pin_name == PIN_NAME_NC) {
+    return;
+  }
+  attachInterruptParam(pin_name, callback, mode, param);
 }
 
 void attachInterrupt(pin_size_t interruptNumber, voidFuncPtr callback, PinStatus mode)
@@ -157,3 +188,17 @@ void attachInterrupt(pin_size_t interruptNumber, voidFuncPtr callback, PinStatus
   }
   attachInterrupt(pin_name, callback, mode);
 }
+
+void attachInterruptEvent(PinName pin, PinStatus mode)
+{
+  attach_interrupt_handler(pin, nullptr, nullptr, nullptr, mode, true);
+}
+
+void attachInterruptEvent(pin_size_t pin, PinStatus mode)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return;
+  }
+  attachInterruptEvent(pin_name, mode);
+}
@@ -38,15 +38,53 @@ void tone(uint8_t _pin, unsigned int frequency, unsigned long duration)
 
 void tone(PinName pin, unsigned int frequency, unsigned long duration)
 {
-  PWM.frequency_mode(pin, frequency);
   if (duration == 0) {
+    PWM.frequency_mode(pin, frequency);
     return;
   }
-  uint32_t tone_end_time = millis() + duration;
-  while (millis() < tone_end_time) {
-    yield();
+  // Replace the tone or melody playing on the pin with a note which is stopped in the background
+  PWM.frequency_mode(pin, 0);
+  PWM.tone_queue(pin, frequency, duration);
+}
+
+bool toneQueue(pin_size_t pin, unsigned int frequency, unsigned long duration)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return false;
   }
-  noTone(pin);
+  return toneQueue(pin_name, frequency, duration);
+}
+
+bool toneQueue(PinName pin, unsigned int frequency, unsigned long duration)
+{
+  return PWM.tone_queue(pin, frequency, duration);
+}
+
+size_t playMelody(pin_size_t pin, const tone_note_t* notes, size_t num_notes)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return 0u;
+  }
+  return playMelody(pin_name, notes, num_notes);
+}
+
+size_t playMelody(PinName pin, const tone_note_t* notes, size_t num_notes)
+{
+  if (notes == nullptr) {
+    return 0u;
+  }
+  size_t queued = 0u;
+  while (queued < num_notes && PWM.tone_queue(pin, notes[queued].frequency, notes[queued].duration)) {
+    queued++;
+  }
+  return queued;
+}
+
+bool isTonePlaying()
+{
+  return PWM.is_tone_playing();
 }
 
 void noTone(uint8_t _pin)
@@ -25,82 +25,271 @@
  */
 
 #include "adc.h"
+#include "em_core.h"
+
+static void adc_task_hook()
+{
+  ADC.task();
+}
 
 using namespace arduino;
 
+// Finds an asynchronous PRS channel without a source - emlib's PRS_GetFreeChannel() isn't available on every variant
+static bool get_free_prs_channel(unsigned int& channel)
+{
+  for (unsigned int i = 0u; i < PRS_ASYNC_CH_NUM; i++) {
+    if ((PRS->ASYNC_CH[i].CTRL & _PRS_ASYNC_CH_CTRL_SOURCESEL_MASK) == 0u) {
+      channel = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void letimer_disable()
+{
+  LETIMER0->EN_CLR = LETIMER_EN_EN;
+  #if defined(LETIMER_EN_DISABLING)
+  while (LETIMER0->EN & LETIMER_EN_DISABLING) {
+  }
+  #endif // LETIMER_EN_DISABLING
+}
+
 AdcClass::AdcClass() :
   initialized(false),
   current_adc_pin(PD2),
   current_adc_reference(AR_VDD),
-  adc_mutex(nullptr)
+  current_config_slot(0),
+  read_resolution(adc_default_read_resolution),
+  result_shift(0u),
+  oversampling_ratio(2u),
+  digital_average(1u),
+  high_accuracy(false),
+  adc_mutex(nullptr),
+  async_busy(false),
+  async_ready(false),
+  async_result(0u),
+  async_callback(nullptr),
+  window_monitoring(false),
+  window_in_window(true),
+  window_low_threshold(0u),
+  window_high_threshold(0u),
+  window_threshold_shift(0u),
+  window_callback(nullptr),
+  window_prev_clock_source(cmuSelect_Disabled),
+  window_prs_channel(0u),
+  streaming(false),
+  stream_dma_channel(0u),
+  stream_buffer(nullptr),
+  stream_half_size(0u),
+  stream_callback(nullptr),
+  stream_ready_mask(0u),
+  stream_next_half(0u),
+  stream_overrun_count(0u)
 {
+  for (uint8_t i = 0; i < IADC0_CONFIGNUM; i++) {
+    this->config_slot_reference[i] = AR_MAX;
+  }
   this->adc_mutex = xSemaphoreCreateMutexStatic(&this->adc_mutex_buf);
   configASSERT(this->adc_mutex);
 }
 
 void AdcClass::init(PinName pin, uint8_t reference)
 {
+  if (reference >= AR_MAX) {
+    return;
+  }
+
   // Set up the ADC pin as an input
   pinMode(pin, INPUT);
 
-  // Create ADC init structs with default values
-  IADC_Init_t init = IADC_INIT_DEFAULT;
-  IADC_AllConfigs_t all_configs = IADC_ALLCONFIGS_DEFAULT;
-  IADC_InitSingle_t init_single = IADC_INITSINGLE_DEFAULT;
+  // Look for a config slot which already holds the requested reference
+  bool slot_found = false;
+  uint8_t config_slot = 0;
+  for (uint8_t i = 0; i < IADC0_CONFIGNUM; i++) {
+    if (this->config_slot_reference[i] == reference) {
+      config_slot = i;
+      slot_found = true;
+      break;
+    }
+  }
+  // Otherwise replace the reference in a slot which is not in use right now
+  if (!slot_found) {
+    config_slot = (this->current_config_slot + 1) % IADC0_CONFIGNUM;
+    this->config_slot_reference[config_slot] = reference;
+  }
+
   IADC_SingleInput_t input = IADC_SINGLEINPUT_DEFAULT;
+  input.posInput = GPIO_to_ADC_pin_map[pin - PIN_NAME_MIN];
+  input.configId = config_slot;
 
-  // Enable IADC0, GPIO and PRS clock branches
-  CMU_ClockEnable(cmuClock_IADC0, true);
-  CMU_ClockEnable(cmuClock_GPIO, true);
-  CMU_ClockEnable(cmuClock_PRS, true);
+  if (this->initialized && slot_found) {
+    // The IADC is already configured for the reference - only switch the input
+    IADC_updateSingleInput(IADC0, &input);
+  } else {
+    // Create ADC init structs with default values
+    IADC_Init_t init = IADC_INIT_DEFAULT;
+    IADC_AllConfigs_t all_configs = IADC_ALLCONFIGS_DEFAULT;
+    IADC_InitSingle_t init_single = IADC_INITSINGLE_DEFAULT;
+
+    // Enable IADC0, GPIO and PRS clock branches
+    CMU_ClockEnable(cmuClock_IADC0, true);
+    CMU_ClockEnable(cmuClock_GPIO, true);
+    CMU_ClockEnable(cmuClock_PRS, true);
+
+    // Set the voltage reference and the oversampling of every used config slot
+    // The ADC clock is kept within the limit of the slot's ADC mode - it's lower in high accuracy mode
+    init.srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, adc_src_clk_freq, 0);
+    for (uint8_t i = 0; i < IADC0_CONFIGNUM; i++) {
+      (void)this->set_reference_config(this->config_slot_reference[i], all_configs.configs[i]);
+      this->set_oversampling_config(all_configs.configs[i]);
+      all_configs.configs[i].adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
+                                                                      limit_adc_clk_freq(adc_clk_freq_max_normal, all_configs.configs[i].adcMode),
+                                                                      0,
+                                                                      all_configs.configs[i].adcMode,
+                                                                      init.srcClkPrescale);
+    }
+
+    // Read 16 bit results if more than the default resolution is requested
+    if (this->read_resolution > adc_default_read_resolution) {
+      init_single.alignment = iadcAlignRight16;
+    }
+
+    // Reset and initialize the ADC
+    IADC_reset(IADC0);
+    IADC_init(IADC0, &init, &all_configs);
+    IADC_initSingle(IADC0, &init_single, &input);
+    IADC_enableInt(IADC0, IADC_IEN_SINGLEDONE);
+  }
 
-  IADC_CfgReference_t sl_adc_reference;
-  uint32_t sl_adc_vref;
+  this->allocate_analog_bus(pin);
 
-  // Set the voltage reference
+  this->current_config_slot = config_slot;
+  this->initialized = true;
+}
+
+bool AdcClass::set_reference_config(uint8_t reference, IADC_Config_t& config)
+{
   switch (reference) {
     case AR_INTERNAL1V2:
-      sl_adc_reference = iadcCfgReferenceInt1V2;
-      sl_adc_vref = 1200;
+      config.reference = iadcCfgReferenceInt1V2;
+      config.vRef = 1200;
       break;
 
     case AR_EXTERNAL_1V25:
-      sl_adc_reference = iadcCfgReferenceExt1V25;
-      sl_adc_vref = 1250;
+      config.reference = iadcCfgReferenceExt1V25;
+      config.vRef = 1250;
       break;
 
     case AR_VDD:
-      sl_adc_reference = iadcCfgReferenceVddx;
-      sl_adc_vref = 3300;
+      config.reference = iadcCfgReferenceVddx;
+      config.vRef = 3300;
       break;
 
     case AR_08VDD:
-      sl_adc_reference = iadcCfgReferenceVddX0P8Buf;
-      sl_adc_vref = 2640;
+      config.reference = iadcCfgReferenceVddX0P8Buf;
+      config.vRef = 2640;
       break;
 
     default:
-      return;
+      return false;
   }
-  all_configs.configs[0].reference = sl_adc_reference;
-  all_configs.configs[0].vRef = sl_adc_vref;
+  return true;
+}
 
-  // Reset the ADC
-  IADC_reset(IADC0);
+void AdcClass::set_oversampling_config(IADC_Config_t& config)
+{
+  #if defined(_IADC_CFG_ADCMODE_HIGHACCURACY)
+  if (this->high_accuracy) {
+    config.adcMode = iadcCfgModeHighAccuracy;
+    switch (this->oversampling_ratio) {
+      case 16u:
+        config.osrHighAccuracy = iadcCfgOsrHighAccuracy16x;
+        break;
+      case 32u:
+        config.osrHighAccuracy = iadcCfgOsrHighAccuracy32x;
+        break;
+      case 64u:
+        config.osrHighAccuracy = iadcCfgOsrHighAccuracy64x;
+        break;
+      case 128u:
+        config.osrHighAccuracy = iadcCfgOsrHighAccuracy128x;
+        break;
+      case 256u:
+        config.osrHighAccuracy = iadcCfgOsrHighAccuracy256x;
+        break;
+      default:
+        config.osrHighAccuracy = iadcCfgOsrHighAccuracy92x;
+        break;
+    }
+  }
+  #endif // _IADC_CFG_ADCMODE_HIGHACCURACY
 
-  // Only configure the ADC if it is not already running
-  if (IADC0->CTRL == _IADC_CTRL_RESETVALUE) {
-    IADC_init(IADC0, &init, &all_configs);
+  if (!this->high_accuracy) {
+    switch (this->oversampling_ratio) {
+      case 4u:
+        config.osrHighSpeed = iadcCfgOsrHighSpeed4x;
+        break;
+      case 8u:
+        config.osrHighSpeed = iadcCfgOsrHighSpeed8x;
+        break;
+      case 16u:
+        config.osrHighSpeed = iadcCfgOsrHighSpeed16x;
+        break;
+      case 32u:
+        config.osrHighSpeed = iadcCfgOsrHighSpeed32x;
+        break;
+      case 64u:
+        config.osrHighSpeed = iadcCfgOsrHighSpeed64x;
+        break;
+      default:
+        config.osrHighSpeed = iadcCfgOsrHighSpeed2x;
+        break;
+    }
+  }
+
+  #if defined(_IADC_CFG_DIGAVG_MASK)
+  switch (this->digital_average) {
+    case 2u:
+      config.digAvg = iadcDigitalAverage2;
+      break;
+    case 4u:
+      config.digAvg = iadcDigitalAverage4;
+      break;
+    case 8u:
+      config.digAvg = iadcDigitalAverage8;
+      break;
+    case 16u:
+      config.digAvg = iadcDigitalAverage16;
+      break;
+    default:
+      config.digAvg = iadcDigitalAverage1;
+      break;
   }
+  #endif // _IADC_CFG_DIGAVG_MASK
+}
 
-  // Assign the input pin
-  uint32_t pin_index = pin - PIN_NAME_MIN;
-  input.posInput = GPIO_to_ADC_pin_map[pin_index];
+uint32_t AdcClass::limit_adc_clk_freq(uint32_t adc_clk_freq, IADC_CfgAdcMode_t mode)
+{
+  #if defined(_IADC_CFG_ADCMODE_HIGHACCURACY)
+  if (mode == iadcCfgModeHighAccuracy && adc_clk_freq > adc_clk_freq_max_high_accuracy) {
+    return adc_clk_freq_max_high_accuracy;
+  }
+  #endif // _IADC_CFG_ADCMODE_HIGHACCURACY
+  (void)mode;
+  if (adc_clk_freq > adc_clk_freq_max_normal) {
+    return adc_clk_freq_max_normal;
+  }
+  return adc_clk_freq;
+}
 
-  // Initialize the ADC
-  IADC_initSingle(IADC0, &init_single, &input);
-  IADC_enableInt(IADC0, IADC_IEN_SINGLEDONE);
+uint16_t AdcClass::scale_result(uint32_t result)
+{
+  return (uint16_t)(result >> this->result_shift);
+}
 
+void AdcClass::allocate_analog_bus(PinName pin)
+{
   // Allocate the analog bus for ADC0 inputs
   // Port C and D are handled together
   // Even and odd pins on the same port have a different register value
@@ -124,14 +313,19 @@ void AdcClass::init(PinName pin, uint8_t reference)
       GPIO->ABUSALLOC |= GPIO_ABUSALLOC_AODD0_ADC0;
     }
   }
-
-  this->initialized = true;
 }
 
 uint16_t AdcClass::get_sample(PinName pin)
 {
   xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
 
+  // The IADC is occupied while streaming or monitoring
+  if (this->streaming || this->window_monitoring) {
+    xSemaphoreGive(this->adc_mutex);
+    return 0;
+  }
+  this->wait_for_async_sample();
+
   if (!this->initialized || pin != this->current_adc_pin) {
     this->current_adc_pin = pin;
     this->init(this->current_adc_pin, this->current_adc_reference);
@@ -144,12 +338,163 @@ uint16_t AdcClass::get_sample(PinName pin)
   while (!(IADC_getInt(IADC0) & IADC_IF_SINGLEDONE)) {
     yield();
   }
-  uint16_t result = IADC_readSingleData(IADC0);
+  uint16_t result = this->scale_result(IADC_readSingleData(IADC0));
 
   xSemaphoreGive(this->adc_mutex);
   return result;
 }
 
+bool AdcClass::get_scan_samples(const PinName* pins, uint8_t num_pins, uint16_t* results)
+{
+  if (pins == nullptr || results == nullptr || num_pins == 0 || num_pins > max_scan_pins) {
+    return false;
+  }
+  for (uint8_t i = 0; i < num_pins; i++) {
+    if (pins[i] < PIN_NAME_MIN || pins[i] >= PIN_NAME_MAX) {
+      return false;
+    }
+  }
+
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+
+  // The IADC is occupied while streaming or monitoring
+  if (this->streaming || this->window_monitoring) {
+    xSemaphoreGive(this->adc_mutex);
+    return false;
+  }
+  this->wait_for_async_sample();
+
+  if (!this->initialized) {
+    this->init(this->current_adc_pin, this->current_adc_reference);
+  }
+
+  // Fill the scan table with the requested pins - the entry ID is the index in 'pins'
+  IADC_InitScan_t init_scan = IADC_INITSCAN_DEFAULT;
+  IADC_ScanTable_t scan_table = IADC_SCANTABLE_DEFAULT;
+  init_scan.showId = true;
+  init_scan.dataValidLevel = iadcFifoCfgDvl1;
+  if (this->read_resolution > adc_default_read_resolution) {
+    init_scan.alignment = iadcAlignRight16;
+  }
+  for (uint8_t i = 0; i < num_pins; i++) {
+    pinMode(pins[i], INPUT);
+    this->allocate_analog_bus(pins[i]);
+    scan_table.entries[i].posInput = GPIO_to_ADC_pin_map[pins[i] - PIN_NAME_MIN];
+    scan_table.entries[i].negInput = iadcNegInputGnd;
+    scan_table.entries[i].configId = this->current_config_slot;
+    scan_table.entries[i].includeInScan = true;
+  }
+  IADC_initScan(IADC0, &init_scan, &scan_table);
+
+  // Discard any leftover results of a previous scan
+  while (IADC_getScanFifoCnt(IADC0) > 0) {
+    (void)IADC_pullScanFifoResult(IADC0);
+  }
+
+  // Start the scan and read the results from the FIFO as they arrive
+  IADC_clearInt(IADC0, IADC_IF_SCANTABLEDONE);
+  IADC_command(IADC0, iadcCmdStartScan);
+  uint8_t num_results = 0;
+  while (num_results < num_pins) {
+    if (IADC_getScanFifoCnt(IADC0) == 0) {
+      yield();
+      continue;
+    }
+    IADC_Result_t result = IADC_pullScanFifoResult(IADC0);
+    if (result.id < num_pins) {
+      results[result.id] = this->scale_result(result.data);
+    }
+    num_results++;
+  }
+
+  xSemaphoreGive(this->adc_mutex);
+  return true;
+}
+
+bool AdcClass::start_sample_async(PinName pin, adc_read_callback_t callback)
+{
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX) {
+    return false;
+  }
+
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+
+  // The IADC is occupied while streaming, monitoring or converting
+  if (this->streaming || this->window_monitoring || this->async_busy) {
+    xSemaphoreGive(this->adc_mutex);
+    return false;
+  }
+
+  if (!this->initialized || pin != this->current_adc_pin) {
+    this->current_adc_pin = pin;
+    this->init(this->current_adc_pin, this->current_adc_reference);
+  }
+
+  this->async_callback = callback;
+  this->async_ready = false;
+  // The result is delivered to the callback from the Arduino task
+  if (callback != nullptr) {
+    register_arduino_task_hook(&adc_task_hook);
+  }
+  this->async_busy = true;
+
+  // Start the conversion - the result is read in the single done interrupt
+  IADC_clearInt(IADC0, IADC_IF_SINGLEDONE);
+  NVIC_ClearPendingIRQ(IADC_IRQn);
+  NVIC_EnableIRQ(IADC_IRQn);
+  IADC_command(IADC0, iadcCmdStartSingle);
+
+  xSemaphoreGive(this->adc_mutex);
+  return true;
+}
+
+bool AdcClass::is_async_sample_ready()
+{
+  return this->async_ready;
+}
+
+uint16_t AdcClass::get_async_sample()
+{
+  this->async_ready = false;
+  return this->async_result;
+}
+
+void AdcClass::wait_for_async_sample()
+{
+  while (this->async_busy) {
+    yield();
+  }
+}
+
+void AdcClass::irq_handler()
+{
+  if (this->window_monitoring) {
+    IADC_clearInt(IADC0, IADC_IF_SINGLECMP);
+    // Only the results matching the comparator are stored - use the latest one
+    uint32_t result = 0u;
+    while (IADC_getSingleFifoCnt(IADC0) > 0) {
+      result = IADC_pullSingleFifoData(IADC0);
+    }
+    // Arm the comparator for crossing back
+    this->window_in_window = !this->window_in_window;
+    this->set_window_thresholds();
+    if (this->window_callback != nullptr) {
+      this->window_callback(this->scale_result(result), this->window_in_window);
+    }
+    return;
+  }
+
+  IADC_clearInt(IADC0, IADC_IF_SINGLEDONE);
+  // Blocking conversions poll the interrupt flag - the IRQ is only enabled for asynchronous ones
+  NVIC_DisableIRQ(IADC_IRQn);
+  if (!this->async_busy) {
+    return;
+  }
+  this->async_result = this->scale_result(IADC_readSingleData(IADC0));
+  this->async_busy = false;
+  this->async_ready = true;
+}
+
 void AdcClass::set_reference(uint8_t reference)
 {
   if (reference >= AR_MAX || reference == this->current_adc_reference) {
@@ -157,8 +502,417 @@ void AdcClass::set_reference(uint8_t reference)
   }
   xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
   this->current_adc_reference = reference;
-  this->init(this->current_adc_pin, this->current_adc_reference);
+  // The new reference is applied when streaming or monitoring is started again
+  if (!this->streaming && !this->window_monitoring) {
+    this->wait_for_async_sample();
+    this->init(this->current_adc_pin, this->current_adc_reference);
+  }
+  xSemaphoreGive(this->adc_mutex);
+}
+
+void AdcClass::set_read_resolution(uint8_t resolution)
+{
+  if (resolution < 1u || resolution > adc_max_read_resolution) {
+    return;
+  }
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  this->read_resolution = resolution;
+  // Results are read with 12 bits, or with 16 bits if more is requested
+  if (resolution > adc_default_read_resolution) {
+    this->result_shift = adc_max_read_resolution - resolution;
+  } else {
+    this->result_shift = adc_default_read_resolution - resolution;
+  }
+  // The result alignment is applied on the next full initialization
+  this->initialized = false;
+  xSemaphoreGive(this->adc_mutex);
+}
+
+bool AdcClass::set_oversampling(uint16_t ratio, uint8_t digital_average)
+{
+  bool ratio_valid = false;
+  if (this->high_accuracy) {
+    ratio_valid = (ratio == 16u || ratio == 32u || ratio == 64u || ratio == 92u || ratio == 128u || ratio == 256u);
+  } else {
+    ratio_valid = (ratio == 2u || ratio == 4u || ratio == 8u || ratio == 16u || ratio == 32u || ratio == 64u);
+  }
+  if (!ratio_valid) {
+    return false;
+  }
+
+  #if defined(_IADC_CFG_DIGAVG_MASK)
+  if (digital_average != 1u && digital_average != 2u && digital_average != 4u
+      && digital_average != 8u && digital_average != 16u) {
+    return false;
+  }
+  #else
+  if (digital_average != 1u) {
+    return false;
+  }
+  #endif // _IADC_CFG_DIGAVG_MASK
+
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  this->oversampling_ratio = ratio;
+  this->digital_average = digital_average;
+  // The config slots are reprogrammed on the next full initialization
+  this->initialized = false;
+  xSemaphoreGive(this->adc_mutex);
+  return true;
+}
+
+bool AdcClass::set_high_accuracy_mode(bool enable)
+{
+  #if !defined(_IADC_CFG_ADCMODE_HIGHACCURACY)
+  if (enable) {
+    return false;
+  }
+  #endif // !_IADC_CFG_ADCMODE_HIGHACCURACY
+
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  if (this->high_accuracy != enable) {
+    this->high_accuracy = enable;
+    this->oversampling_ratio = enable ? 92u : 2u;
+    // The config slots are reprogrammed on the next full initialization
+    this->initialized = false;
+  }
+  xSemaphoreGive(this->adc_mutex);
+  return true;
+}
+
+bool AdcClass::window_monitor_start(PinName pin, uint16_t low_threshold, uint16_t high_threshold, uint32_t sample_rate, adc_window_callback_t callback)
+{
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX || callback == nullptr || sample_rate == 0u
+      || high_threshold <= low_threshold + 1u || high_threshold >= (1u << this->read_resolution)) {
+    return false;
+  }
+
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  this->stream_stop_internal();
+  this->window_monitor_stop_internal();
+  this->wait_for_async_sample();
+
+  // The LETIMER triggers the conversions - it runs from the low frequency clock in EM2
+  CMU_ClockEnable(cmuClock_LETIMER0, true);
+  uint32_t letimer_ticks = CMU_ClockFreqGet(cmuClock_LETIMER0) / sample_rate;
+  if (letimer_ticks < 2u || letimer_ticks > _LETIMER_TOP_MASK + 1u) {
+    xSemaphoreGive(this->adc_mutex);
+    return false;
+  }
+
+  // Take a PRS channel which isn't used by anything else for connecting the LETIMER to the IADC
+  CMU_ClockEnable(cmuClock_PRS, true);
+  if (!get_free_prs_channel(this->window_prs_channel)) {
+    xSemaphoreGive(this->adc_mutex);
+    return false;
+  }
+  // Setting the channel's source right away marks it as used
+  PRS->ASYNC_CH[this->window_prs_channel].CTRL = PRS_ASYNC_LETIMER0_CH0 | PRS_ASYNC_CH_CTRL_FNSEL_A;
+
+  pinMode(pin, INPUT);
+  CMU_ClockEnable(cmuClock_IADC0, true);
+  CMU_ClockEnable(cmuClock_GPIO, true);
+
+  // Clock the IADC from the FSRCO which is available in EM2
+  this->window_prev_clock_source = CMU_ClockSelectGet(cmuClock_IADCCLK);
+  CMU_ClockSelectSet(cmuClock_IADCCLK, cmuSelect_FSRCO);
+
+  // The comparator thresholds are compared with the 16 bit results
+  this->window_threshold_shift = adc_max_read_resolution - this->read_resolution;
+  this->window_low_threshold = low_threshold;
+  this->window_high_threshold = high_threshold;
+  this->window_callback = callback;
+  this->window_in_window = true;
+
+  IADC_Init_t init = IADC_INIT_DEFAULT;
+  IADC_AllConfigs_t all_configs = IADC_ALLCONFIGS_DEFAULT;
+  IADC_InitSingle_t init_single = IADC_INITSINGLE_DEFAULT;
+  IADC_SingleInput_t input = IADC_SINGLEINPUT_DEFAULT;
+
+  // Only run the IADC clock while a triggered conversion is in progress
+  init.iadcClkSuspend1 = true;
+  init.srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, CMU_ClockFreqGet(cmuClock_IADCCLK), 0);
+  (void)this->set_reference_config(this->current_adc_reference, all_configs.configs[0]);
+  this->set_oversampling_config(all_configs.configs[0]);
+  all_configs.configs[0].adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
+                                                                  limit_adc_clk_freq(window_adc_clk_freq, all_configs.configs[0].adcMode),
+                                                                  0,
+                                                                  all_configs.configs[0].adcMode,
+                                                                  init.srcClkPrescale);
+
+  // Each LETIMER underflow starts one conversion
+  init_single.triggerSelect = iadcTriggerSelPrs0PosEdge;
+  init_single.triggerAction = iadcTriggerActionOnce;
+  if (this->read_resolution > adc_default_read_resolution) {
+    init_single.alignment = iadcAlignRight16;
+  }
+  input.posInput = GPIO_to_ADC_pin_map[pin - PIN_NAME_MIN];
+  input.compare = true;
+
+  IADC_reset(IADC0);
+  IADC_init(IADC0, &init, &all_configs);
+  IADC_initSingle(IADC0, &init_single, &input);
+  this->allocate_analog_bus(pin);
+  // The regular single conversion setup has to be restored after monitoring
+  this->initialized = false;
+  this->set_window_thresholds();
+
+  // Connect the LETIMER to the IADC single trigger
+  PRS->CONSUMER_IADC0_SINGLETRIGGER = this->window_prs_channel << _PRS_CONSUMER_IADC0_SINGLETRIGGER_PRSSEL_SHIFT;
+
+  // Only wake up on window crossings
+  IADC_clearInt(IADC0, _IADC_IF_MASK);
+  IADC_enableInt(IADC0, IADC_IEN_SINGLECMP);
+  NVIC_ClearPendingIRQ(IADC_IRQn);
+  NVIC_EnableIRQ(IADC_IRQn);
+
+  this->window_monitoring = true;
+  IADC_command(IADC0, iadcCmdStartSingle);
+
+  // Pulse the LETIMER output on each underflow
+  letimer_disable();
+  LETIMER0->CTRL = LETIMER_CTRL_UFOA0_PULSE | LETIMER_CTRL_CNTTOPEN;
+  LETIMER0->EN_SET = LETIMER_EN_EN;
+  while (LETIMER0->SYNCBUSY) {
+  }
+  LETIMER0->TOP = letimer_ticks - 1u;
+  LETIMER0->CNT = letimer_ticks - 1u;
+  while (LETIMER0->SYNCBUSY) {
+  }
+  LETIMER0->CMD = LETIMER_CMD_START;
+
+  xSemaphoreGive(this->adc_mutex);
+  return true;
+}
+
+void AdcClass::window_monitor_stop()
+{
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  this->window_monitor_stop_internal();
+  xSemaphoreGive(this->adc_mutex);
+}
+
+void AdcClass::window_monitor_stop_internal()
+{
+  if (!this->window_monitoring) {
+    return;
+  }
+  // Stop the LETIMER and disconnect it from the IADC
+  while (LETIMER0->SYNCBUSY) {
+  }
+  LETIMER0->CMD = LETIMER_CMD_STOP;
+  while (LETIMER0->SYNCBUSY) {
+  }
+  letimer_disable();
+  PRS->CONSUMER_IADC0_SINGLETRIGGER = _PRS_CONSUMER_IADC0_SINGLETRIGGER_RESETVALUE;
+  // Resetting the channel's source frees it for other users
+  PRS->ASYNC_CH[this->window_prs_channel].CTRL = _PRS_ASYNC_CH_CTRL_RESETVALUE;
+
+  IADC_command(IADC0, iadcCmdStopSingle);
+  NVIC_DisableIRQ(IADC_IRQn);
+  IADC_disableInt(IADC0, IADC_IEN_SINGLECMP);
+  CMU_ClockSelectSet(cmuClock_IADCCLK, this->window_prev_clock_source);
+  this->window_monitoring = false;
+}
+
+bool AdcClass::is_window_monitoring()
+{
+  return this->window_monitoring;
+}
+
+void AdcClass::set_window_thresholds()
+{
+  uint32_t low = (uint32_t)this->window_low_threshold << this->window_threshold_shift;
+  uint32_t high = (uint32_t)this->window_high_threshold << this->window_threshold_shift;
+  uint32_t lsb = 1u << this->window_threshold_shift;
+  uint32_t greater_equal;
+  uint32_t less_equal;
+  if (this->window_in_window) {
+    // Greater-equal above less-equal matches samples outside of the window
+    greater_equal = high;
+    less_equal = low + lsb - 1u;
+  } else {
+    // Greater-equal below less-equal matches samples inside of the window
+    greater_equal = low + lsb;
+    less_equal = high - 1u;
+  }
+  IADC0->CMPTHR = (greater_equal << _IADC_CMPTHR_ADGT_SHIFT) | (less_equal << _IADC_CMPTHR_ADLT_SHIFT);
+}
+
+bool AdcClass::stream_start(PinName pin, uint32_t sample_rate, uint32_t* buffer, uint32_t buffer_size, adc_stream_callback_t callback)
+{
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX || buffer == nullptr || callback == nullptr || sample_rate == 0u
+      || buffer_size < 2u || (buffer_size % 2u) != 0u || (buffer_size / 2u) > (uint32_t)DMADRV_MAX_XFER_COUNT) {
+    return false;
+  }
+
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  this->stream_stop_internal();
+  this->window_monitor_stop_internal();
+  this->wait_for_async_sample();
+
+  // Allocate a DMA channel for moving the samples from the IADC FIFO to the buffer
+  Ecode_t dma_init_res = DMADRV_Init();
+  if (dma_init_res != ECODE_OK && dma_init_res != ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED) {
+    xSemaphoreGive(this->adc_mutex);
+    return false;
+  }
+  if (DMADRV_AllocateChannel(&this->stream_dma_channel, nullptr) != ECODE_OK) {
+    xSemaphoreGive(this->adc_mutex);
+    return false;
+  }
+
+  pinMode(pin, INPUT);
+  CMU_ClockEnable(cmuClock_IADC0, true);
+  CMU_ClockEnable(cmuClock_GPIO, true);
+
+  IADC_Init_t init = IADC_INIT_DEFAULT;
+  IADC_AllConfigs_t all_configs = IADC_ALLCONFIGS_DEFAULT;
+  IADC_InitSingle_t init_single = IADC_INITSINGLE_DEFAULT;
+  IADC_SingleInput_t input = IADC_SINGLEINPUT_DEFAULT;
+  (void)this->set_reference_config(this->current_adc_reference, all_configs.configs[0]);
+  this->set_oversampling_config(all_configs.configs[0]);
+
+  // The IADC's local timer triggers the conversions - it counts the prescaled source clock
+  init.srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, stream_src_clk_freq, 0);
+  // Keep the ADC clock within the limit of the selected mode
+  all_configs.configs[0].adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
+                                                                  limit_adc_clk_freq(stream_adc_clk_freq, all_configs.configs[0].adcMode),
+                                                                  0,
+                                                                  all_configs.configs[0].adcMode,
+                                                                  init.srcClkPrescale);
+  uint32_t src_clk_freq = CMU_ClockFreqGet(cmuClock_IADCCLK) / (init.srcClkPrescale + 1u);
+  uint32_t timer_cycles = src_clk_freq / sample_rate;
+  if (timer_cycles == 0u || timer_cycles > (_IADC_TIMER_TIMER_MASK >> _IADC_TIMER_TIMER_SHIFT)) {
+    DMADRV_FreeChannel(this->stream_dma_channel);
+    xSemaphoreGive(this->adc_mutex);
+    return false;
+  }
+  init.timerCycles = (uint16_t)timer_cycles;
+
+  init_single.triggerSelect = iadcTriggerSelTimer;
+  init_single.triggerAction = iadcTriggerActionContinuous;
+  init_single.dataValidLevel = iadcFifoCfgDvl1;
+  init_single.fifoDmaWakeup = true;
+  if (this->read_resolution > adc_default_read_resolution) {
+    init_single.alignment = iadcAlignRight16;
+  }
+  input.posInput = GPIO_to_ADC_pin_map[pin - PIN_NAME_MIN];
+
+  IADC_reset(IADC0);
+  IADC_init(IADC0, &init, &all_configs);
+  IADC_initSingle(IADC0, &init_single, &input);
+  this->allocate_analog_bus(pin);
+  // The regular single conversion setup has to be restored after streaming
+  this->initialized = false;
+
+  this->stream_buffer = buffer;
+  this->stream_half_size = buffer_size / 2u;
+  this->stream_callback = callback;
+  this->stream_ready_mask = 0u;
+  this->stream_next_half = 0u;
+  // The filled halves are delivered to the callback from the Arduino task
+  register_arduino_task_hook(&adc_task_hook);
+
+  // Fill the two halves of the buffer alternately
+  DMADRV_PeripheralMemoryPingPong(this->stream_dma_channel,
+                                  dmadrvPeripheralSignal_IADC0_IADC_SINGLE,
+                                  this->stream_buffer,
+                                  this->stream_buffer + this->stream_half_size,
+                                  (void*)&IADC0->SINGLEFIFODATA,
+                                  true,
+                                  (int)this->stream_half_size,
+                                  dmadrvDataSize4,
+                                  &AdcClass::stream_dma_callback,
+                                  this);
+
+  #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+  // Require at least EM1 to keep the IADC clock running
+  sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+  #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+
+  this->streaming = true;
+  IADC_command(IADC0, iadcCmdEnableTimer);
+  IADC_command(IADC0, iadcCmdStartSingle);
+
   xSemaphoreGive(this->adc_mutex);
+  return true;
+}
+
+void AdcClass::stream_stop()
+{
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  this->stream_stop_internal();
+  xSemaphoreGive(this->adc_mutex);
+}
+
+void AdcClass::stream_stop_internal()
+{
+  if (!this->streaming) {
+    return;
+  }
+  IADC_command(IADC0, iadcCmdDisableTimer);
+  IADC_command(IADC0, iadcCmdStopSingle);
+  DMADRV_StopTransfer(this->stream_dma_channel);
+  DMADRV_FreeChannel(this->stream_dma_channel);
+  this->streaming = false;
+
+  #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+  // Remove the energy mode requirement
+  sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+  #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+}
+
+bool AdcClass::is_streaming()
+{
+  return this->streaming;
+}
+
+uint32_t AdcClass::get_stream_overrun_count()
+{
+  return this->stream_overrun_count;
+}
+
+void AdcClass::task()
+{
+  // Hand the result of an asynchronous measurement to its callback
+  if (this->async_ready && this->async_callback != nullptr) {
+    adc_read_callback_t callback = this->async_callback;
+    this->async_ready = false;
+    callback(this->async_result);
+  }
+
+  if (!this->streaming) {
+    return;
+  }
+  // Hand the filled halves to the callback in the order they were filled
+  while (this->stream_ready_mask & (1u << this->stream_next_half)) {
+    // Scale the raw FIFO words to the read resolution in place
+    uint32_t* samples = this->stream_buffer + this->stream_next_half * this->stream_half_size;
+    for (uint32_t i = 0u; i < this->stream_half_size; i++) {
+      samples[i] = this->scale_result(samples[i]);
+    }
+    this->stream_callback(samples, this->stream_half_size);
+    CORE_DECLARE_IRQ_STATE;
+    CORE_ENTER_ATOMIC();
+    this->stream_ready_mask &= (uint8_t)~(1u << this->stream_next_half);
+    CORE_EXIT_ATOMIC();
+    this->stream_next_half ^= 1u;
+  }
+}
+
+bool AdcClass::stream_dma_callback(unsigned int channel, unsigned int sequence_num, void* user_param)
+{
+  (void)channel;
+  AdcClass* adc = static_cast<AdcClass*>(user_param);
+  // Odd sequence numbers complete the first half, even ones the second half
+  uint8_t half_mask = (sequence_num & 1u) ? 0x01u : 0x02u;
+  if (adc->stream_ready_mask & half_mask) {
+    // The half was refilled before the callback processed it
+    adc->stream_overrun_count = adc->stream_overrun_count + 1u;
+  }
+  adc->stream_ready_mask |= half_mask;
+  // Keep the ping-pong transfer running
+  return true;
 }
 
 const IADC_PosInput_t AdcClass::GPIO_to_ADC_pin_map[64] = {
@@ -233,3 +987,8 @@ const IADC_PosInput_t AdcClass::GPIO_to_ADC_pin_map[64] = {
 };
 
 arduino::AdcClass ADC;
+
+void IADC_IRQHandler(void)
+{
+  ADC.irq_handler();
+}
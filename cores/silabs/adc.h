@@ -29,10 +29,10 @@
 #ifndef __ARDUINO_ADC_H
 #define __ARDUINO_ADC_H
 
-#include <cmath>
 #include <inttypes.h>
 #include "em_cmu.h"
 #include "em_iadc.h"
+#include "dmadrv.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
 
@@ -44,6 +44,10 @@ enum analog_references {
   AR_MAX              // Maximum value
 };
 
+typedef void (*adc_read_callback_t)(uint16_t sample);
+typedef void (*adc_window_callback_t)(uint16_t sample, bool in_window);
+typedef void (*adc_stream_callback_t)(const uint32_t* samples, uint32_t num_samples);
+
 namespace arduino {
 class AdcClass {
 public:
@@ -61,6 +65,46 @@ public:
    ******************************************************************************/
   uint16_t get_sample(PinName pin);
 
+  /***************************************************************************//**
+   * Performs an ADC measurement on multiple pins in one hardware scan sequence
+   * The pins are converted back-to-back by the IADC scan table and the results
+   * are read from the scan FIFO.
+   *
+   * @param[in] pins The pins to measure
+   * @param[in] num_pins The number of pins - at most 'max_scan_pins'
+   * @param[out] results The measured samples in the order of 'pins'
+   *
+   * @return true if the measurement was successful, false otherwise
+   ******************************************************************************/
+  bool get_scan_samples(const PinName* pins, uint8_t num_pins, uint16_t* results);
+
+  /***************************************************************************//**
+   * Starts an ADC measurement on the provided pin and returns immediately
+   * The result is captured in the IADC interrupt when the conversion completes.
+   * It can be polled with is_async_sample_ready() and get_async_sample(), or
+   * it's handed to the callback from the Arduino task (after each loop()).
+   *
+   * @param[in] pin The pin number of the ADC input
+   * @param[in] callback Called with the result - can be nullptr for polling
+   *
+   * @return true if the measurement was started, false if the ADC is busy
+   ******************************************************************************/
+  bool start_sample_async(PinName pin, adc_read_callback_t callback);
+
+  /***************************************************************************//**
+   * Returns whether the result of an asynchronous measurement is ready
+   *
+   * @return true if a result is ready, false otherwise
+   ******************************************************************************/
+  bool is_async_sample_ready();
+
+  /***************************************************************************//**
+   * Returns the result of the last asynchronous measurement
+   *
+   * @return the measured ADC sample
+   ******************************************************************************/
+  uint16_t get_async_sample();
+
   /***************************************************************************//**
    * Sets the ADC voltage reference
    *
@@ -68,22 +112,266 @@ public:
    ******************************************************************************/
   void set_reference(uint8_t reference);
 
+  /***************************************************************************//**
+   * Sets the resolution of the samples returned by get_sample() and get_scan_samples()
+   * Above 12 bits the 16 bit result of the IADC is read - the additional bits
+   * only carry information when oversampling is enabled with set_oversampling().
+   *
+   * @param[in] resolution The requested resolution in bits (1-16)
+   ******************************************************************************/
+  void set_read_resolution(uint8_t resolution);
+
+  /***************************************************************************//**
+   * Sets the hardware oversampling of the ADC
+   * Each conversion is oversampled by the IADC and optionally multiple
+   * conversions are averaged by the digital averaging, which reduces noise and
+   * increases the effective resolution without any CPU involvement.
+   * Valid oversampling ratios are 2, 4, 8, 16, 32 and 64 in normal mode and
+   * 16, 32, 64, 92, 128 and 256 in high accuracy mode.
+   *
+   * @param[in] ratio The oversampling ratio
+   * @param[in] digital_average The number of averaged conversions (1, 2, 4, 8 or 16)
+   *
+   * @return true if the setting is valid, false otherwise
+   ******************************************************************************/
+  bool set_oversampling(uint16_t ratio, uint8_t digital_average = 1u);
+
+  /***************************************************************************//**
+   * Enables or disables the high accuracy mode of the ADC
+   * The oversampling ratio is reset to the default of the selected mode
+   * (92 in high accuracy mode and 2 in normal mode).
+   * High accuracy mode is not available on all devices.
+   *
+   * @param[in] enable true to enable high accuracy mode, false to disable it
+   *
+   * @return true if the mode was set, false if it's not available on the device
+   ******************************************************************************/
+  bool set_high_accuracy_mode(bool enable);
+
+  /***************************************************************************//**
+   * Starts streaming ADC samples from a pin into a buffer
+   * The conversions are triggered by the IADC's timer at the requested sample rate
+   * and the results are moved to the buffer by the LDMA without CPU involvement.
+   * The buffer is used as two halves - while one half is being filled the other
+   * one is handed to the callback from the Arduino task (after each loop()).
+   * The callback has to process a half before the LDMA wraps around to it
+   * again, otherwise an overrun is counted. analogRead() and analogReadMulti()
+   * don't work while streaming is running.
+   * The samples are converted with the current oversampling settings and are
+   * scaled to the read resolution (analogReadResolution()) like the results of
+   * analogRead() before they're handed to the callback.
+   *
+   * @param[in] pin The pin number of the ADC input
+   * @param[in] sample_rate The sample rate in hertz
+   * @param[in] buffer The buffer for the samples
+   * @param[in] buffer_size The number of samples in the buffer - must be even,
+   *                        at most twice 'DMADRV_MAX_XFER_COUNT'
+   * @param[in] callback Called with each filled half of the buffer
+   *
+   * @return true if streaming started, false otherwise
+   ******************************************************************************/
+  bool stream_start(PinName pin, uint32_t sample_rate, uint32_t* buffer, uint32_t buffer_size, adc_stream_callback_t callback);
+
+  /***************************************************************************//**
+   * Stops streaming ADC samples
+   ******************************************************************************/
+  void stream_stop();
+
+  /***************************************************************************//**
+   * Returns whether streaming is running
+   *
+   * @return true if streaming is running, false otherwise
+   ******************************************************************************/
+  bool is_streaming();
+
+  /***************************************************************************//**
+   * Returns the number of buffer halves overwritten before the callback processed them
+   *
+   * @return the number of stream overruns
+   ******************************************************************************/
+  uint32_t get_stream_overrun_count();
+
+  /***************************************************************************//**
+   * Starts monitoring a pin with the window comparator of the ADC
+   * The conversions are triggered at the requested rate by the LETIMER through
+   * the PRS, and the ADC is clocked from the FSRCO - both keep running in EM2.
+   * The CPU is only woken up when a sample crosses the window - the callback is
+   * called from interrupt context when the sample leaves the window (at or below
+   * 'low_threshold' or at or above 'high_threshold') and when it returns into it.
+   * The thresholds are in the read resolution (see set_read_resolution()).
+   * The LETIMER and a free asynchronous PRS channel are used while monitoring -
+   * monitoring doesn't start when no PRS channel is free.
+   * analogRead(), analogReadMulti(), analogReadAsync() and streaming don't work
+   * while monitoring is running.
+   *
+   * @param[in] pin The pin number of the ADC input
+   * @param[in] low_threshold The lower threshold of the window
+   * @param[in] high_threshold The upper threshold of the window
+   * @param[in] sample_rate The sample rate in hertz
+   * @param[in] callback Called with the sample on each window crossing
+   *
+   * @return true if monitoring started, false otherwise
+   ******************************************************************************/
+  bool window_monitor_start(PinName pin, uint16_t low_threshold, uint16_t high_threshold, uint32_t sample_rate, adc_window_callback_t callback);
+
+  /***************************************************************************//**
+   * Stops monitoring with the window comparator
+   ******************************************************************************/
+  void window_monitor_stop();
+
+  /***************************************************************************//**
+   * Returns whether window monitoring is running
+   *
+   * @return true if window monitoring is running, false otherwise
+   ******************************************************************************/
+  bool is_window_monitoring();
+
+  /***************************************************************************//**
+   * Delivers asynchronous results and the filled stream buffer halves to the
+   * callbacks - called by the Arduino task
+   ******************************************************************************/
+  void task();
+
+  /***************************************************************************//**
+   * Handles the IADC interrupt - called from IADC_IRQHandler
+   ******************************************************************************/
+  void irq_handler();
+
+  // The maximum number of pins in a scan sequence
+  static const uint8_t max_scan_pins = IADC0_ENTRIES;
+  // The maximum read resolution - also the resolution of the results in the IADC FIFO when reading more than 12 bits
+  static const uint8_t adc_max_read_resolution = 16u;
+
 private:
   /***************************************************************************//**
    * Initializes the ADC hardware
+   * The IADC is only reset and fully configured when the requested reference is
+   * not held by one of its config slots yet - otherwise only the input mux and
+   * the analog bus allocation are switched to the new pin.
    *
    * @param[in] pin The pin number of the ADC input
    * @param[in] reference The selected voltage reference from 'analog_references'
    ******************************************************************************/
   void init(PinName pin, uint8_t reference);
 
+  /***************************************************************************//**
+   * Allocates the analog bus of the pin for the ADC
+   *
+   * @param[in] pin The pin number of the ADC input
+   ******************************************************************************/
+  void allocate_analog_bus(PinName pin);
+
+  /***************************************************************************//**
+   * Gets the IADC reference configuration for a reference
+   *
+   * @param[in] reference The selected voltage reference from 'analog_references'
+   * @param[out] config The IADC config to set the reference in
+   *
+   * @return true if the reference is valid, false otherwise
+   ******************************************************************************/
+  bool set_reference_config(uint8_t reference, IADC_Config_t& config);
+
+  /***************************************************************************//**
+   * Sets the oversampling and digital averaging in an IADC config
+   *
+   * @param[in] config The IADC config to set the oversampling in
+   ******************************************************************************/
+  void set_oversampling_config(IADC_Config_t& config);
+
+  /***************************************************************************//**
+   * Limits an IADC clock frequency to the maximum of an ADC mode
+   *
+   * @param[in] adc_clk_freq The requested IADC clock frequency in hertz
+   * @param[in] mode The ADC mode of the IADC config
+   *
+   * @return the requested frequency or the maximum of the mode if it's lower
+   ******************************************************************************/
+  static uint32_t limit_adc_clk_freq(uint32_t adc_clk_freq, IADC_CfgAdcMode_t mode);
+
+  /***************************************************************************//**
+   * Scales a result read from the IADC FIFO to the read resolution
+   *
+   * @param[in] result The result read from the IADC FIFO
+   *
+   * @return the result scaled to the read resolution
+   ******************************************************************************/
+  uint16_t scale_result(uint32_t result);
+
+  /***************************************************************************//**
+   * Waits for a running asynchronous measurement - must be called with 'adc_mutex' held
+   ******************************************************************************/
+  void wait_for_async_sample();
+
+  /***************************************************************************//**
+   * Arms the window comparator for the next crossing of the window
+   ******************************************************************************/
+  void set_window_thresholds();
+
+  /***************************************************************************//**
+   * Stops window monitoring - must be called with 'adc_mutex' held
+   ******************************************************************************/
+  void window_monitor_stop_internal();
+
+  /***************************************************************************//**
+   * Stops streaming - must be called with 'adc_mutex' held
+   ******************************************************************************/
+  void stream_stop_internal();
+
+  static bool stream_dma_callback(unsigned int channel, unsigned int sequence_num, void* user_param);
+
   bool initialized;
   PinName current_adc_pin;
   uint8_t current_adc_reference;
+  // Voltage reference held by each IADC config slot - 'AR_MAX' if unused
+  uint8_t config_slot_reference[IADC0_CONFIGNUM];
+  uint8_t current_config_slot;
+  uint8_t read_resolution;
+  // Right shift from the hardware result to the read resolution - updated with the resolution
+  uint8_t result_shift;
+  uint16_t oversampling_ratio;
+  uint8_t digital_average;
+  bool high_accuracy;
   static const IADC_PosInput_t GPIO_to_ADC_pin_map[64];
+  // Default resolution of the samples
+  static const uint8_t adc_default_read_resolution = 12u;
+  // Frequency of the IADC source clock for single and scan conversions
+  static const uint32_t adc_src_clk_freq = 20000000u;
+  // Maximum frequency of the IADC clock in normal and high accuracy mode
+  static const uint32_t adc_clk_freq_max_normal = 10000000u;
+  static const uint32_t adc_clk_freq_max_high_accuracy = 5000000u;
 
   SemaphoreHandle_t adc_mutex;
   StaticSemaphore_t adc_mutex_buf;
+
+  volatile bool async_busy;
+  volatile bool async_ready;
+  volatile uint16_t async_result;
+  adc_read_callback_t async_callback;
+
+  bool window_monitoring;
+  bool window_in_window;
+  uint16_t window_low_threshold;
+  uint16_t window_high_threshold;
+  uint8_t window_threshold_shift;
+  adc_window_callback_t window_callback;
+  CMU_Select_TypeDef window_prev_clock_source;
+  // PRS channel connecting the LETIMER to the IADC trigger - allocated while monitoring
+  unsigned int window_prs_channel;
+  // Frequency of the IADC clock while monitoring - limited further by the ADC mode
+  static const uint32_t window_adc_clk_freq = 10000000u;
+
+  bool streaming;
+  unsigned int stream_dma_channel;
+  uint32_t* stream_buffer;
+  uint32_t stream_half_size;
+  adc_stream_callback_t stream_callback;
+  volatile uint8_t stream_ready_mask;
+  uint8_t stream_next_half;
+  volatile uint32_t stream_overrun_count;
+  // Frequency of the IADC source clock while streaming
+  static const uint32_t stream_src_clk_freq = 20000000u;
+  // Frequency of the IADC clock while streaming - limited further by the ADC mode
+  static const uint32_t stream_adc_clk_freq = 10000000u;
 };
 } // namespace arduino
 
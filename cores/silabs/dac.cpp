@@ -29,41 +29,62 @@
 #ifdef NUM_DAC_HW
 
 #include "arduino_dac_config.h"
+#include "em_core.h"
 
 using namespace arduino;
 
+static void dac_task_hook();
+
 DacClass::DacClass(VDAC_TypeDef *vdac_peripheral, PinName ch0_pin, PinName ch1_pin) :
   dac_initialized(false),
   ch0_pin(ch0_pin),
   ch1_pin(ch1_pin),
-  ch0_initialized(false),
-  ch1_initialized(false),
+  ch0_enabled(false),
+  ch1_enabled(false),
   ch0_value(0),
   ch1_value(0),
   auto_deinit(true),
   write_resolution(8),
-  dac_max_value(255),
-  voltage_ref(vdacRef1V25)
+  write_scaler(255u, dac_true_max_value),
+  voltage_ref(vdacRef1V25),
+  waveform_sample_rate(0u),
+  waveform_actual_rate(0u),
+  waveform_prescaler(0u),
+  waveform_timer_overflow(vdacCycles2),
+  timer_sample_rate(0u)
 {
   this->vdac_peripheral = vdac_peripheral;
+  for (uint8_t i = 0; i < 2; i++) {
+    this->waveforms[i].running = false;
+    this->waveforms[i].looping = false;
+    this->waveforms[i].finished = false;
+    this->waveforms[i].dma_channel = 0u;
+    this->waveforms[i].buffer = nullptr;
+    this->waveforms[i].half_size = 0u;
+    this->waveforms[i].callback = nullptr;
+    this->waveforms[i].refill_mask = 0u;
+    this->waveforms[i].next_half = 0u;
+    this->waveforms[i].underrun_count = 0u;
+    this->channel_timer_triggered[i] = false;
+  }
 }
 
 void DacClass::set_output(uint8_t channel_num, uint32_t value)
 {
-  if (value > this->dac_max_value || channel_num > 1) {
+  if (value > this->write_scaler.get_input_max() || channel_num > 1) {
     return;
   }
 
+  // Writing a value stops the waveform playing on the channel
+  this->stop_waveform(channel_num);
+
   if (value == 0 && this->auto_deinit) {
-    this->deinit(channel_num);
+    this->disable_channel(channel_num);
     return;
   }
 
   // Map the value from the current write resolution to 12 bits (true resolution)
-  uint32_t value_out = value;
-  if (this->write_resolution != this->dac_true_bit_resolution) {
-    value_out = map(value, 0, this->dac_max_value, 0, this->dac_true_max_value);
-  }
+  uint32_t value_out = this->write_scaler.scale(value);
 
   this->init(channel_num);
   VDAC_ChannelOutputSet(this->vdac_peripheral, channel_num, value_out);
@@ -87,44 +108,49 @@ void DacClass::init(uint8_t channel_num)
     init.reference = this->voltage_ref;
 
     // Use the HFRCOEM23 to clock the VDAC in order to operate in EM3 mode
-    if (this->vdac_peripheral == VDAC0) {
-      CMU_ClockSelectSet(cmuClock_VDAC0, cmuSelect_HFRCOEM23);
-    } else if (this->vdac_peripheral == VDAC1) {
-      CMU_ClockSelectSet(cmuClock_VDAC1, cmuSelect_HFRCOEM23);
-    } else {
+    CMU_Clock_TypeDef vdac_clock;
+    if (!this->select_clock(vdac_clock)) {
       return;
     }
 
-    // Enable the HFRCOEM23 and VDAC clocks
-    CMU_ClockEnable(cmuClock_HFRCOEM23, true);
-
     // Enable the VDAC peripheral clock
-    if (this->vdac_peripheral == VDAC0) {
-      CMU_ClockEnable(cmuClock_VDAC0, true);
-    } else if (this->vdac_peripheral == VDAC1) {
-      CMU_ClockEnable(cmuClock_VDAC1, true);
+    CMU_ClockEnable(vdac_clock, true);
+
+    if (this->waveform_sample_rate != 0u) {
+      // Run the internal timer at the waveform sample rate and let the LDMA wake up in EM2/EM3
+      init.prescaler = this->waveform_prescaler;
+      init.timerOverflow = this->waveform_timer_overflow;
+      init.dmaWakeUp = true;
     } else {
-      return;
+      // Calculate the VDAC clock prescaler value resulting in a 1 MHz VDAC clock
+      init.prescaler = VDAC_PrescaleCalc(this->vdac_peripheral, this->vdac_max_freq);
     }
 
-    // Calculate the VDAC clock prescaler value resulting in a 1 MHz VDAC clock
-    init.prescaler = VDAC_PrescaleCalc(this->vdac_peripheral, this->vdac_max_freq);
-
     // Clocking is requested on demand
     init.onDemandClk = false;
 
     // Initialize the VDAC and VDAC channel
     VDAC_Init(this->vdac_peripheral, &init);
+    this->timer_sample_rate = this->waveform_sample_rate;
+
+    // Configure both channels while the VDAC is disabled - changing the configuration
+    // later would need disabling the whole VDAC which interrupts the other channel
+    this->init_channel(0);
+    this->init_channel(1);
 
     this->dac_initialized = true;
   }
 
-  // Initialize the requested channel
-  if (channel_num == 0 && !this->ch0_initialized) {
-    this->init_channel(0);
+  // Enable the requested channel - this leaves the other channel running
+  if (channel_num == 0 && !this->ch0_enabled) {
+    GPIO_PinModeSet(getSilabsPortFromArduinoPin(this->ch0_pin), getSilabsPinFromArduinoPin(this->ch0_pin), gpioModeWiredOr, 0);
+    VDAC_Enable(this->vdac_peripheral, 0, true);
+    this->ch0_enabled = true;
   }
-  if (channel_num == 1 && !this->ch1_initialized) {
-    this->init_channel(1);
+  if (channel_num == 1 && !this->ch1_enabled) {
+    GPIO_PinModeSet(getSilabsPortFromArduinoPin(this->ch1_pin), getSilabsPinFromArduinoPin(this->ch1_pin), gpioModeWiredOr, 0);
+    VDAC_Enable(this->vdac_peripheral, 1, true);
+    this->ch1_enabled = true;
   }
 }
 
@@ -134,14 +160,6 @@ void DacClass::init_channel(uint8_t channel_num)
     return;
   }
 
-  // Set the DAC output pin's mode to 'gpioModeWiredOr'
-  if (channel_num == 0) {
-    GPIO_PinModeSet(getSilabsPortFromArduinoPin(this->ch0_pin), getSilabsPinFromArduinoPin(this->ch0_pin), gpioModeWiredOr, 0);
-  }
-  if (channel_num == 1) {
-    GPIO_PinModeSet(getSilabsPortFromArduinoPin(this->ch1_pin), getSilabsPinFromArduinoPin(this->ch1_pin), gpioModeWiredOr, 0);
-  }
-
   // Use default settings
   VDAC_InitChannel_TypeDef initChannel = VDAC_INITCHANNEL_DEFAULT;
 
@@ -151,52 +169,111 @@ void DacClass::init_channel(uint8_t channel_num)
   // Use Low Power mode
   initChannel.powerMode = vdacPowerModeLowPower;
 
+  // Waveforms are converted on the internal timer's overflows
+  if (this->waveforms[channel_num].running) {
+    initChannel.trigMode = vdacTrigModeInternalTimer;
+  }
+
   VDAC_InitChannel(this->vdac_peripheral, &initChannel, channel_num);
+  this->channel_timer_triggered[channel_num] = this->waveforms[channel_num].running;
+}
 
-  // Enable the VDAC
-  VDAC_Enable(this->vdac_peripheral, channel_num, true);
+void DacClass::deinit(uint8_t channel_num)
+{
+  if (channel_num > 1 || !this->dac_initialized) {
+    return;
+  }
 
-  if (channel_num == 0) {
-    this->ch0_initialized = true;
+  // Reset the whole hardware - the channel configuration can only be changed while the VDAC is disabled
+  // The other channel which is still enabled will jump to 0V for a brief moment while it's reinitialized
+  // Use disable_channel() to turn off a channel without affecting the other one
+  bool other_enabled = (channel_num == 0) ? this->ch1_enabled : this->ch0_enabled;
+  this->reset();
+  if (other_enabled) {
+    this->enable_channel(channel_num ^ 1u);
   }
-  if (channel_num == 1) {
-    this->ch1_initialized = true;
+}
+
+void DacClass::reset()
+{
+  if (this->dac_initialized) {
+    VDAC_Reset(this->vdac_peripheral);
   }
+  this->dac_initialized = false;
+  this->ch0_enabled = false;
+  this->ch1_enabled = false;
+  this->timer_sample_rate = 0u;
 }
 
-void DacClass::deinit(uint8_t channel_num)
+void DacClass::enable_channel(uint8_t channel_num)
 {
   if (channel_num > 1) {
     return;
   }
-  if (channel_num == 0 && !this->ch0_initialized) {
+  bool was_enabled = (channel_num == 0) ? this->ch0_enabled : this->ch1_enabled;
+  this->init(channel_num);
+  // A playing waveform continues from the LDMA - otherwise restore the last output value
+  if (was_enabled || this->waveforms[channel_num].running) {
     return;
   }
-  if (channel_num == 1 && !this->ch1_initialized) {
+  if (channel_num == 0) {
+    VDAC_ChannelOutputSet(this->vdac_peripheral, 0, this->ch0_value);
+  }
+  if (channel_num == 1) {
+    VDAC_ChannelOutputSet(this->vdac_peripheral, 1, this->ch1_value);
+  }
+}
+
+void DacClass::disable_channel(uint8_t channel_num)
+{
+  if (channel_num > 1) {
     return;
   }
+  this->stop_waveform(channel_num);
+  this->turn_off_channel(channel_num);
+}
 
-  // Reset the whole hardware - we don't have the means to deinitialize a separate channel
-  // The other channel which is still enabled will jump to 0V for a brief moment while it's reinitialized
-  VDAC_Reset(this->vdac_peripheral);
-  this->dac_initialized = false;
+void DacClass::turn_off_channel(uint8_t channel_num)
+{
+  if (channel_num == 0 && this->ch0_enabled) {
+    VDAC_Enable(this->vdac_peripheral, 0, false);
+    this->ch0_enabled = false;
+  }
+  if (channel_num == 1 && this->ch1_enabled) {
+    VDAC_Enable(this->vdac_peripheral, 1, false);
+    this->ch1_enabled = false;
+  }
+
+  // Turn off the hardware when neither channel is used
+  if (!this->ch0_enabled && !this->ch1_enabled) {
+    this->reset();
+  }
+}
 
-  // Reinitialize the other channel if it's still enabled
+void DacClass::set_output_raw(uint8_t channel_num, uint16_t value)
+{
+  // Write the data FIFO directly - the channel keeps its output until the new value is converted
   if (channel_num == 0) {
-    this->ch0_initialized = false;
-    if (this->ch1_initialized) {
-      this->ch1_initialized = false;
-      this->set_output(1, this->ch1_value);
-    }
+    VDAC_Channel0OutputSet(this->vdac_peripheral, value & this->dac_true_max_value);
+    this->ch0_value = value & this->dac_true_max_value;
+  } else if (channel_num == 1) {
+    VDAC_Channel1OutputSet(this->vdac_peripheral, value & this->dac_true_max_value);
+    this->ch1_value = value & this->dac_true_max_value;
   }
+}
 
-  if (channel_num == 1) {
-    this->ch1_initialized = false;
-    if (this->ch0_initialized) {
-      this->ch0_initialized = false;
-      this->set_output(0, this->ch0_value);
-    }
+bool DacClass::select_clock(CMU_Clock_TypeDef& vdac_clock)
+{
+  if (this->vdac_peripheral == VDAC0) {
+    vdac_clock = cmuClock_VDAC0;
+  } else if (this->vdac_peripheral == VDAC1) {
+    vdac_clock = cmuClock_VDAC1;
+  } else {
+    return false;
   }
+  CMU_ClockSelectSet(vdac_clock, cmuSelect_HFRCOEM23);
+  CMU_ClockEnable(cmuClock_HFRCOEM23, true);
+  return true;
 }
 
 void DacClass::set_auto_deinit(bool auto_deinit)
@@ -206,18 +283,19 @@ void DacClass::set_auto_deinit(bool auto_deinit)
 
 void DacClass::set_write_resolution(uint8_t resolution)
 {
-  if (resolution < 1 || resolution > this->dac_true_bit_resolution) {
+  if (resolution < 1 || resolution > this->dac_max_write_resolution) {
     return;
   }
   this->write_resolution = resolution;
-  this->dac_max_value = pow(2, this->write_resolution) - 1;
+  this->write_scaler.set_input_resolution(resolution);
 }
 
 void DacClass::set_voltage_reference(dac_voltage_ref_t reference)
 {
-  // Deinitialize both channels
-  this->deinit(0);
-  this->deinit(1);
+  // Stop the waveforms and turn off both channels
+  this->stop_waveform(0);
+  this->stop_waveform(1);
+  this->reset();
 
   switch (reference) {
     case DAC_VREF_1V25:
@@ -239,6 +317,276 @@ void DacClass::set_voltage_reference(dac_voltage_ref_t reference)
   }
 }
 
+bool DacClass::play_waveform(uint8_t channel_num, const uint16_t* samples, uint32_t num_samples, uint32_t sample_rate, bool loop)
+{
+  // The LDMA only reads the samples
+  return this->start_waveform(channel_num, const_cast<uint16_t*>(samples), num_samples, sample_rate, loop, nullptr);
+}
+
+bool DacClass::stream_waveform(uint8_t channel_num, uint16_t* buffer, uint32_t buffer_size, uint32_t sample_rate, dac_waveform_callback_t callback)
+{
+  if (callback == nullptr || buffer_size < 2u || (buffer_size % 2u) != 0u) {
+    return false;
+  }
+  return this->start_waveform(channel_num, buffer, buffer_size / 2u, sample_rate, true, callback);
+}
+
+bool DacClass::start_waveform(uint8_t channel_num, uint16_t* buffer, uint32_t num_samples, uint32_t sample_rate, bool loop, dac_waveform_callback_t callback)
+{
+  if (channel_num > 1 || buffer == nullptr || num_samples == 0u
+      || num_samples > (uint32_t)DMADRV_MAX_XFER_COUNT || sample_rate == 0u) {
+    return false;
+  }
+
+  this->stop_waveform(channel_num);
+
+  // The internal timer is shared by the channels
+  uint8_t other_channel = channel_num ^ 1u;
+  if (this->waveforms[other_channel].running && sample_rate != this->waveform_sample_rate) {
+    if (!this->waveforms[other_channel].finished) {
+      return false;
+    }
+    // A finished one-shot waveform doesn't need the timer anymore
+    this->stop_waveform(other_channel);
+  }
+
+  uint32_t prescaler;
+  VDAC_TimerOverflow_TypeDef timer_overflow;
+  uint32_t actual_rate;
+  if (!this->calc_waveform_timer(sample_rate, prescaler, timer_overflow, actual_rate)) {
+    return false;
+  }
+
+  // The channel's trigger mode and the internal timer can only be changed with the whole hardware reset
+  // That's not needed when the channel still converts on the timer at the same rate after a previous waveform
+  bool other_enabled = (other_channel == 0) ? this->ch0_enabled : this->ch1_enabled;
+  bool reconfigure = !this->dac_initialized || !this->channel_timer_triggered[channel_num]
+                     || this->timer_sample_rate != sample_rate;
+  // A reset would drop the static output of the other channel to 0V - refuse instead
+  if (reconfigure && other_enabled && !this->waveforms[other_channel].running) {
+    return false;
+  }
+
+  // Allocate a DMA channel for moving the samples to the VDAC channel's FIFO
+  waveform_state_t* waveform = &this->waveforms[channel_num];
+  Ecode_t dma_init_res = DMADRV_Init();
+  if (dma_init_res != ECODE_OK && dma_init_res != ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED) {
+    return false;
+  }
+  if (DMADRV_AllocateChannel(&waveform->dma_channel, nullptr) != ECODE_OK) {
+    return false;
+  }
+
+  // The waveform of the other channel is interrupted for a brief moment while the hardware is reconfigured
+  if (reconfigure) {
+    this->reset();
+  }
+  if (sample_rate != this->waveform_sample_rate) {
+    this->waveform_sample_rate = sample_rate;
+    this->waveform_actual_rate = actual_rate;
+    this->waveform_prescaler = prescaler;
+    this->waveform_timer_overflow = timer_overflow;
+  }
+
+  waveform->buffer = buffer;
+  waveform->half_size = num_samples;
+  waveform->callback = callback;
+  waveform->looping = loop;
+  waveform->finished = false;
+  waveform->refill_mask = 0u;
+  waveform->next_half = 0u;
+  waveform->running = true;
+
+  // Fill both halves of the stream buffer before starting - the later refills are requested from the Arduino task
+  if (callback != nullptr) {
+    register_arduino_task_hook(&dac_task_hook);
+    callback(buffer, num_samples);
+    callback(buffer + num_samples, num_samples);
+  }
+
+  this->init(channel_num);
+  if (reconfigure && other_enabled) {
+    this->enable_channel(other_channel);
+  }
+
+  DMADRV_PeripheralSignal_t dma_signal;
+  void* fifo = (channel_num == 0) ? (void*)&this->vdac_peripheral->CH0F : (void*)&this->vdac_peripheral->CH1F;
+  if (this->vdac_peripheral == VDAC0) {
+    dma_signal = (DMADRV_PeripheralSignal_t)((channel_num == 0 ? LDMAXBAR_CH_REQSEL_SIGSEL_VDAC0CH0_REQ : LDMAXBAR_CH_REQSEL_SIGSEL_VDAC0CH1_REQ)
+                                             | LDMAXBAR_CH_REQSEL_SOURCESEL_VDAC0);
+  } else {
+    dma_signal = (DMADRV_PeripheralSignal_t)((channel_num == 0 ? LDMAXBAR_CH_REQSEL_SIGSEL_VDAC1CH0_REQ : LDMAXBAR_CH_REQSEL_SIGSEL_VDAC1CH1_REQ)
+                                             | LDMAXBAR_CH_REQSEL_SOURCESEL_VDAC1);
+  }
+
+  if (callback != nullptr) {
+    // Play the two halves of the buffer alternately
+    DMADRV_MemoryPeripheralPingPong(waveform->dma_channel, dma_signal, fifo,
+                                    buffer, buffer + num_samples, true, (int)num_samples,
+                                    dmadrvDataSize2, &DacClass::waveform_dma_callback, waveform);
+  } else if (loop) {
+    // Play the same buffer over and over
+    DMADRV_MemoryPeripheralPingPong(waveform->dma_channel, dma_signal, fifo,
+                                    buffer, buffer, true, (int)num_samples,
+                                    dmadrvDataSize2, &DacClass::waveform_dma_callback, waveform);
+  } else {
+    DMADRV_MemoryPeripheral(waveform->dma_channel, dma_signal, fifo,
+                            buffer, true, (int)num_samples,
+                            dmadrvDataSize2, &DacClass::waveform_dma_callback, waveform);
+  }
+  return true;
+}
+
+bool DacClass::calc_waveform_timer(uint32_t sample_rate, uint32_t& prescaler, VDAC_TimerOverflow_TypeDef& overflow, uint32_t& actual_rate)
+{
+  static const VDAC_TimerOverflow_TypeDef overflows[] = {
+    vdacCycles2, vdacCycles4, vdacCycles8, vdacCycles16, vdacCycles32, vdacCycles64
+  };
+  static const uint32_t max_prescaler = _VDAC_CFG_PRESC_MASK >> _VDAC_CFG_PRESC_SHIFT;
+
+  CMU_Clock_TypeDef vdac_clock;
+  if (!this->select_clock(vdac_clock)) {
+    return false;
+  }
+  uint32_t src_freq = CMU_ClockFreqGet(vdac_clock);
+  // The prescaled VDAC clock must not exceed the maximum frequency
+  uint32_t min_divider = (src_freq + this->vdac_max_freq - 1u) / this->vdac_max_freq;
+
+  // Find the prescaler and overflow period pair which is the closest to the requested rate
+  uint32_t best_error = UINT32_MAX;
+  for (uint8_t i = 0; i < sizeof(overflows) / sizeof(overflows[0]); i++) {
+    uint32_t cycles = 2u << i;
+    uint64_t ticks_per_sample = (uint64_t)sample_rate * cycles;
+    uint32_t divider = (uint32_t)(((uint64_t)src_freq + ticks_per_sample / 2u) / ticks_per_sample);
+    if (divider < min_divider) {
+      divider = min_divider;
+    }
+    if (divider > max_prescaler + 1u) {
+      continue;
+    }
+    uint32_t rate = src_freq / (divider * cycles);
+    uint32_t error = (rate > sample_rate) ? (rate - sample_rate) : (sample_rate - rate);
+    if (error < best_error) {
+      best_error = error;
+      prescaler = divider - 1u;
+      overflow = overflows[i];
+      actual_rate = rate;
+    }
+  }
+  return best_error != UINT32_MAX;
+}
+
+void DacClass::stop_waveform(uint8_t channel_num)
+{
+  if (channel_num > 1 || !this->waveforms[channel_num].running) {
+    return;
+  }
+  waveform_state_t* waveform = &this->waveforms[channel_num];
+  DMADRV_StopTransfer(waveform->dma_channel);
+  DMADRV_FreeChannel(waveform->dma_channel);
+  waveform->running = false;
+  // The internal timer is free again when no channel plays a waveform
+  if (!this->waveforms[channel_num ^ 1u].running) {
+    this->waveform_sample_rate = 0u;
+  }
+  // Turn off only this channel - the other channel keeps running without a glitch
+  // The channel keeps converting on the internal timer until the hardware is reset, which happens
+  // when both channels are off - reconfiguring it earlier would drop the other channel to 0V
+  this->turn_off_channel(channel_num);
+}
+
+bool DacClass::is_waveform_playing(uint8_t channel_num)
+{
+  if (channel_num > 1) {
+    return false;
+  }
+  return this->waveforms[channel_num].running && !this->waveforms[channel_num].finished;
+}
+
+uint32_t DacClass::get_waveform_sample_rate()
+{
+  return this->waveform_actual_rate;
+}
+
+uint32_t DacClass::get_waveform_underrun_count(uint8_t channel_num)
+{
+  if (channel_num > 1) {
+    return 0u;
+  }
+  return this->waveforms[channel_num].underrun_count;
+}
+
+void DacClass::task()
+{
+  for (uint8_t i = 0; i < 2; i++) {
+    waveform_state_t* waveform = &this->waveforms[i];
+    if (!waveform->running || waveform->callback == nullptr) {
+      continue;
+    }
+    // Hand the played halves to the callback in the order they were played
+    while (waveform->refill_mask & (1u << waveform->next_half)) {
+      waveform->callback(waveform->buffer + waveform->next_half * waveform->half_size, waveform->half_size);
+      CORE_DECLARE_IRQ_STATE;
+      CORE_ENTER_ATOMIC();
+      waveform->refill_mask &= (uint8_t)~(1u << waveform->next_half);
+      CORE_EXIT_ATOMIC();
+      waveform->next_half ^= 1u;
+    }
+  }
+}
+
+bool DacClass::waveform_dma_callback(unsigned int channel, unsigned int sequence_num, void* user_param)
+{
+  (void)channel;
+  waveform_state_t* waveform = static_cast<waveform_state_t*>(user_param);
+  if (waveform->callback == nullptr) {
+    // A one-shot waveform is finished after its only transfer
+    if (!waveform->looping) {
+      waveform->finished = true;
+    }
+    return waveform->looping;
+  }
+  // Odd sequence numbers complete the first half, even ones the second half
+  uint8_t half_mask = (sequence_num & 1u) ? 0x01u : 0x02u;
+  if (waveform->refill_mask & half_mask) {
+    // The half is played again before the callback refilled it
+    waveform->underrun_count = waveform->underrun_count + 1u;
+  }
+  waveform->refill_mask |= half_mask;
+  // Keep the ping-pong transfer running
+  return true;
+}
+
+void DacClass::generate_waveform(dac_waveform_shape_t shape, uint16_t* buffer, uint32_t num_samples)
+{
+  if (buffer == nullptr || num_samples == 0u) {
+    return;
+  }
+  for (uint32_t i = 0; i < num_samples; i++) {
+    uint32_t value = 0u;
+    switch (shape) {
+      case DAC_WAVEFORM_SINE:
+        value = (uint32_t)lroundf((sinf(2.0f * (float)M_PI * (float)i / (float)num_samples) + 1.0f) * 0.5f * (float)dac_true_max_value);
+        break;
+      case DAC_WAVEFORM_TRIANGLE:
+      {
+        // Rises during the first half of the period and falls during the second half
+        uint32_t position = (uint32_t)((uint64_t)i * 2u * dac_true_max_value / num_samples);
+        value = (position <= dac_true_max_value) ? position : (2u * dac_true_max_value - position);
+        break;
+      }
+      case DAC_WAVEFORM_SAWTOOTH:
+        if (num_samples > 1u) {
+          value = (uint32_t)((uint64_t)i * dac_true_max_value / (num_samples - 1u));
+        }
+        break;
+      default:
+        break;
+    }
+    buffer[i] = (uint16_t)value;
+  }
+}
+
 #if (NUM_DAC_HW > 0)
 arduino::DacClass DAC_0(VDAC0, SL_DAC0_CH0_PIN, SL_DAC0_CH1_PIN);
 #endif
@@ -247,4 +595,14 @@ arduino::DacClass DAC_0(VDAC0, SL_DAC0_CH0_PIN, SL_DAC0_CH1_PIN);
 arduino::DacClass DAC_1(VDAC1, SL_DAC1_CH0_PIN, SL_DAC1_CH1_PIN);
 #endif
 
+static void dac_task_hook()
+{
+  #if (NUM_DAC_HW > 0)
+  DAC_0.task();
+  #endif // (NUM_DAC_HW > 0)
+  #if (NUM_DAC_HW > 1)
+  DAC_1.task();
+  #endif // (NUM_DAC_HW > 1)
+}
+
 #endif // NUM_DAC_HW
@@ -33,6 +33,8 @@
 
 #include "em_cmu.h"
 #include "em_vdac.h"
+#include "dmadrv.h"
+#include "resolution_scaler.h"
 
 enum dac_voltage_ref_t {
   DAC_VREF_1V25 = 0,          // 1.25V
@@ -41,6 +43,14 @@ enum dac_voltage_ref_t {
   DAC_VREF_EXTERNAL_PIN       // External VREF pin (PA00 if available)
 };
 
+enum dac_waveform_shape_t {
+  DAC_WAVEFORM_SINE = 0,
+  DAC_WAVEFORM_TRIANGLE,
+  DAC_WAVEFORM_SAWTOOTH
+};
+
+typedef void (*dac_waveform_callback_t)(uint16_t* samples, uint32_t num_samples);
+
 namespace arduino {
 class DacClass {
 public:
@@ -63,6 +73,19 @@ public:
    ******************************************************************************/
   void set_output(uint8_t channel_num, uint32_t value);
 
+  /***************************************************************************//**
+   * Sets the specified DAC channel's output to a raw 12 bit value
+   * A fast path for frequent updates - the value is written to the channel's
+   * data FIFO without mapping it from the write resolution and without any
+   * initialization checks. The output keeps its previous value until the new
+   * one is converted, so the update is glitch-free.
+   * The channel has to be enabled first with enable_channel() or set_output().
+   *
+   * @param[in] channel_num the DAC channel to be set
+   * @param[in] value the 12 bit value (0-4095) to set the DAC channel to
+   ******************************************************************************/
+  void set_output_raw(uint8_t channel_num, uint16_t value);
+
   /***************************************************************************//**
    * Initializes the DAC hardware and the requested channel
    *
@@ -72,19 +95,38 @@ public:
 
   /***************************************************************************//**
    * Deintializes the requested DAC channel
+   * Resets the whole DAC hardware - the other channel drops to 0V for a brief
+   * moment while it's reinitialized. Use disable_channel() to turn off a single
+   * channel without affecting the other one.
    *
    * @param[in] channel_num the DAC channel to be deinitialized
    ******************************************************************************/
   void deinit(uint8_t channel_num);
 
   /***************************************************************************//**
-   * Sets whether the DAC channels should automatically deinitialize
-   * when a 0 value is written to it. When deinitializing a channel and an
-   * other channel is still active - the active channel will also
-   * deinitialize momentarily. This is on by default, but it can
-   * interfere with certain applications, so it can be turned off.
-   * Once turned off the user is responsible for deinitializing the DAC and it's
-   * channels by calling deinit().
+   * Enables the output of a DAC channel with its last value
+   * The other channel keeps running without interruption.
+   *
+   * @param[in] channel_num the DAC channel to be enabled
+   ******************************************************************************/
+  void enable_channel(uint8_t channel_num);
+
+  /***************************************************************************//**
+   * Disables the output of a DAC channel
+   * The other channel keeps running without interruption. The DAC hardware is
+   * turned off when neither channel is enabled.
+   *
+   * @param[in] channel_num the DAC channel to be disabled
+   ******************************************************************************/
+  void disable_channel(uint8_t channel_num);
+
+  /***************************************************************************//**
+   * Sets whether the DAC channels should automatically be disabled
+   * when a 0 value is written to them. Disabling a channel doesn't affect
+   * the other channel. This is on by default, but it can interfere with
+   * certain applications, so it can be turned off.
+   * Once turned off the user is responsible for disabling the DAC channels
+   * by calling disable_channel().
    *
    * @param[in] auto_deinit sets whether the auto deinit feature is on or off
    ******************************************************************************/
@@ -92,7 +134,8 @@ public:
 
   /***************************************************************************//**
    * Sets the write resolution in bits.
-   * The default is 8 bits, the maximum is 12 bits.
+   * The default is 8 bits, the maximum is 16 bits - values above the
+   * 12 bit resolution of the hardware are scaled down.
    *
    * @param[in] resolution the requested write resolution in bits
    ******************************************************************************/
@@ -110,32 +153,211 @@ public:
    ******************************************************************************/
   void set_voltage_reference(dac_voltage_ref_t reference);
 
+  /***************************************************************************//**
+   * Plays a buffer of samples on a DAC channel at a fixed sample rate
+   * The conversions are triggered by the VDAC's internal timer and the samples
+   * are moved to the channel by the LDMA without CPU involvement. The internal
+   * timer is shared by the two channels of the DAC, so waveforms playing on
+   * both channels at the same time must use the same sample rate. The timer can
+   * only approximate some sample rates - see get_waveform_sample_rate().
+   * The timer divides the 19 MHz HFRCOEM23 by a prescaler of at most 128 and an
+   * overflow period of at most 64 cycles, and the prescaled clock is limited to
+   * 1 MHz. The sample rate has to be between about 2.3 kHz and 500 kHz - the
+   * playback doesn't start for rates outside of this range.
+   * The samples are 12 bit values (0-4095) regardless of the write resolution,
+   * and the buffer has to stay valid while the waveform is playing.
+   * Switching the channel to the timer trigger needs a reset of the whole DAC
+   * hardware, unless the channel still converts on the timer at the same rate
+   * from a previous waveform. The other channel would drop to 0V during the
+   * reset, so starting fails while it's enabled with a static output - start
+   * the waveform first. A waveform playing on the other channel is interrupted
+   * for a brief moment.
+   *
+   * @param[in] channel_num the DAC channel to play the waveform on
+   * @param[in] samples the samples to play
+   * @param[in] num_samples the number of samples - at most 'DMADRV_MAX_XFER_COUNT'
+   * @param[in] sample_rate the sample rate in hertz
+   * @param[in] loop true to repeat the samples until stopped, false to play them once
+   *
+   * @return true if the playback started, false otherwise
+   ******************************************************************************/
+  bool play_waveform(uint8_t channel_num, const uint16_t* samples, uint32_t num_samples, uint32_t sample_rate, bool loop);
+
+  /***************************************************************************//**
+   * Streams samples to a DAC channel from a double buffer
+   * Works like play_waveform(), but the buffer is used as two halves - while one
+   * half is being played the other one is handed to the callback from the
+   * Arduino task (after each loop()) to be refilled with new samples.
+   * Both halves are filled by the callback before the playback starts.
+   * If a half is not refilled in time it's played again and an underrun is counted.
+   * Starting has the same restrictions regarding the other channel as play_waveform().
+   *
+   * @param[in] channel_num the DAC channel to stream the samples to
+   * @param[in] buffer the buffer for the samples
+   * @param[in] buffer_size the number of samples in the buffer - must be even,
+   *                        at most twice 'DMADRV_MAX_XFER_COUNT'
+   * @param[in] sample_rate the sample rate in hertz
+   * @param[in] callback called with each half of the buffer to be refilled
+   *
+   * @return true if the streaming started, false otherwise
+   ******************************************************************************/
+  bool stream_waveform(uint8_t channel_num, uint16_t* buffer, uint32_t buffer_size, uint32_t sample_rate, dac_waveform_callback_t callback);
+
+  /***************************************************************************//**
+   * Stops the waveform playing on a DAC channel
+   * The channel is turned off, the other channel keeps running without
+   * interruption. The channel's trigger mode can only be changed with the
+   * DAC hardware reset, so while the other channel stays enabled the channel
+   * keeps converting on the internal timer - values written with set_output()
+   * take effect at the next sample period of the stopped waveform.
+   *
+   * @param[in] channel_num the DAC channel to stop
+   ******************************************************************************/
+  void stop_waveform(uint8_t channel_num);
+
+  /***************************************************************************//**
+   * Returns whether a waveform is playing on a DAC channel
+   *
+   * @param[in] channel_num the DAC channel
+   *
+   * @return true if a waveform is playing, false otherwise
+   ******************************************************************************/
+  bool is_waveform_playing(uint8_t channel_num);
+
+  /***************************************************************************//**
+   * Returns the actual sample rate of the waveforms
+   * The VDAC's internal timer produces rates from about 2.3 kHz to 500 kHz,
+   * other rates are rounded to the closest one the timer can produce.
+   *
+   * @return the sample rate produced by the VDAC's internal timer in hertz
+   ******************************************************************************/
+  uint32_t get_waveform_sample_rate();
+
+  /***************************************************************************//**
+   * Returns the number of buffer halves which were not refilled in time while streaming
+   *
+   * @param[in] channel_num the DAC channel
+   *
+   * @return the number of underruns
+   ******************************************************************************/
+  uint32_t get_waveform_underrun_count(uint8_t channel_num);
+
+  /***************************************************************************//**
+   * Hands the played stream buffer halves to the callbacks - called by the Arduino task
+   ******************************************************************************/
+  void task();
+
+  /***************************************************************************//**
+   * Fills a buffer with one period of a waveform for play_waveform()
+   * The waveform spans the full 12 bit range of the DAC.
+   *
+   * @param[in] shape the shape of the waveform from 'dac_waveform_shape_t'
+   * @param[out] buffer the buffer to fill
+   * @param[in] num_samples the number of samples in one period
+   ******************************************************************************/
+  static void generate_waveform(dac_waveform_shape_t shape, uint16_t* buffer, uint32_t num_samples);
+
 private:
   /***************************************************************************//**
-   * Initializes a specific channel of the DAC hardware
+   * Starts playing or streaming a waveform on a DAC channel
    *
-   * @param[in] channel_num the DAC channel to be deinitialized
+   * @param[in] channel_num the DAC channel to play the waveform on
+   * @param[in] buffer the samples to play
+   * @param[in] num_samples the number of samples (in each half when streaming)
+   * @param[in] sample_rate the sample rate in hertz
+   * @param[in] loop whether to repeat the samples
+   * @param[in] callback the refill callback when streaming, nullptr otherwise
+   *
+   * @return true if the playback started, false otherwise
+   ******************************************************************************/
+  bool start_waveform(uint8_t channel_num, uint16_t* buffer, uint32_t num_samples, uint32_t sample_rate, bool loop, dac_waveform_callback_t callback);
+
+  /***************************************************************************//**
+   * Calculates the VDAC internal timer settings closest to a sample rate
+   *
+   * @param[in] sample_rate the requested sample rate in hertz
+   * @param[out] prescaler the VDAC clock prescaler
+   * @param[out] overflow the internal timer overflow period
+   * @param[out] actual_rate the resulting sample rate in hertz
+   *
+   * @return true if the sample rate can be produced, false otherwise
+   ******************************************************************************/
+  bool calc_waveform_timer(uint32_t sample_rate, uint32_t& prescaler, VDAC_TimerOverflow_TypeDef& overflow, uint32_t& actual_rate);
+
+  /***************************************************************************//**
+   * Resets the DAC hardware and disables both channels
+   ******************************************************************************/
+  void reset();
+
+  /***************************************************************************//**
+   * Selects the HFRCOEM23 as the clock of the DAC hardware
+   *
+   * @param[out] vdac_clock the clock of the DAC peripheral
+   *
+   * @return true if the clock was selected, false if the peripheral is invalid
+   ******************************************************************************/
+  bool select_clock(CMU_Clock_TypeDef& vdac_clock);
+
+  static bool waveform_dma_callback(unsigned int channel, unsigned int sequence_num, void* user_param);
+
+  /***************************************************************************//**
+   * Turns off the output of a DAC channel - resets the hardware when neither
+   * channel is enabled anymore
+   *
+   * @param[in] channel_num the DAC channel to be turned off
+   ******************************************************************************/
+  void turn_off_channel(uint8_t channel_num);
+
+  /***************************************************************************//**
+   * Configures a specific channel of the DAC hardware - the VDAC has to be disabled
+   *
+   * @param[in] channel_num the DAC channel to be configured
    ******************************************************************************/
   void init_channel(uint8_t channel_num);
 
   bool dac_initialized;
   PinName ch0_pin;
   PinName ch1_pin;
-  bool ch0_initialized;
-  bool ch1_initialized;
+  bool ch0_enabled;
+  bool ch1_enabled;
   uint32_t ch0_value;
   uint32_t ch1_value;
   bool auto_deinit;
   uint8_t write_resolution;
   VDAC_TypeDef* vdac_peripheral;
-  uint32_t dac_max_value;
+  ResolutionScaler write_scaler;
   VDAC_Ref_TypeDef voltage_ref;
 
+  typedef struct {
+    bool running;
+    bool looping;
+    volatile bool finished;
+    unsigned int dma_channel;
+    uint16_t* buffer;
+    uint32_t half_size;
+    dac_waveform_callback_t callback;
+    volatile uint8_t refill_mask;
+    uint8_t next_half;
+    volatile uint32_t underrun_count;
+  } waveform_state_t;
+
+  waveform_state_t waveforms[2];
+  // Whether a channel is configured in the hardware to convert on the internal timer
+  bool channel_timer_triggered[2];
+  uint32_t waveform_sample_rate;
+  uint32_t waveform_actual_rate;
+  uint32_t waveform_prescaler;
+  VDAC_TimerOverflow_TypeDef waveform_timer_overflow;
+  // The sample rate the internal timer is configured for in the hardware - 0 if it's not used
+  uint32_t timer_sample_rate;
+
   // VDAC to max frequency (1 MHz)
   static const uint32_t vdac_max_freq = 1000000u;
   // The DAC has a 12 bit resolution - the max accepted value is 4095
   static const uint8_t dac_true_bit_resolution = 12u;
   static const uint32_t dac_true_max_value = 4095u;
+  // Accept the same write resolutions as the PWM
+  static const uint8_t dac_max_write_resolution = 16u;
 };
 } // namespace arduino
 
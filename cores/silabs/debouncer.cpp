@@ -0,0 +1,301 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "debouncer.h"
+#include "em_core.h"
+
+using namespace arduino;
+
+static void debouncer_task_hook()
+{
+  Debouncer.task();
+}
+
+DebouncerClass::DebouncerClass() :
+  sample_count(0u),
+  sample_period_ms(5u),
+  long_press_time_ms(1000u),
+  sampling(false),
+  overrun_count(0u),
+  callback(nullptr)
+{
+  for (auto& port : this->ports) {
+    port.button_mask = 0u;
+    port.active_low_mask = 0u;
+    port.level = 0u;
+    port.count0 = 0u;
+    port.count1 = 0u;
+    port.long_press_mask = 0u;
+  }
+}
+
+bool DebouncerClass::add_button(pin_size_t pin, PinStatus active_state)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return false;
+  }
+  return this->add_button(pin_name, active_state);
+}
+
+bool DebouncerClass::add_button(PinName pin, PinStatus active_state)
+{
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX || !get_system_init_finished()) {
+    return false;
+  }
+  GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(pin);
+  uint32_t port_pin = getSilabsPinFromArduinoPin(pin);
+  uint16_t pin_mask = (uint16_t)(1u << port_pin);
+  bool active_low = (active_state == LOW);
+
+  // Pull the pin towards the inactive state
+  GPIO_PinModeSet(port, port_pin, gpioModeInputPull, active_low ? 1u : 0u);
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  debounce_port_t* debounce_port = &this->ports[port];
+  // Start from the current level, so that adding a button doesn't generate an event
+  if (GPIO->P[port].DIN & pin_mask) {
+    debounce_port->level |= pin_mask;
+  } else {
+    debounce_port->level &= (uint16_t)~pin_mask;
+  }
+  if (active_low) {
+    debounce_port->active_low_mask |= pin_mask;
+  } else {
+    debounce_port->active_low_mask &= (uint16_t)~pin_mask;
+  }
+  debounce_port->count0 &= (uint16_t)~pin_mask;
+  debounce_port->count1 &= (uint16_t)~pin_mask;
+  debounce_port->long_press_mask &= (uint16_t)~pin_mask;
+  debounce_port->button_mask |= pin_mask;
+  CORE_EXIT_ATOMIC();
+
+  this->start_sampling();
+  return true;
+}
+
+void DebouncerClass::remove_button(pin_size_t pin)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return;
+  }
+  this->remove_button(pin_name);
+}
+
+void DebouncerClass::remove_button(PinName pin)
+{
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX) {
+    return;
+  }
+  uint16_t pin_mask = (uint16_t)(1u << getSilabsPinFromArduinoPin(pin));
+  bool buttons_left = false;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  this->ports[getSilabsPortFromArduinoPin(pin)].button_mask &= (uint16_t)~pin_mask;
+  this->ports[getSilabsPortFromArduinoPin(pin)].long_press_mask &= (uint16_t)~pin_mask;
+  for (auto& port : this->ports) {
+    if (port.button_mask) {
+      buttons_left = true;
+    }
+  }
+  CORE_EXIT_ATOMIC();
+
+  if (!buttons_left) {
+    this->stop_sampling();
+  }
+}
+
+bool DebouncerClass::is_pressed(pin_size_t pin)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return false;
+  }
+  return this->is_pressed(pin_name);
+}
+
+bool DebouncerClass::is_pressed(PinName pin)
+{
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX) {
+    return false;
+  }
+  uint16_t pin_mask = (uint16_t)(1u << getSilabsPinFromArduinoPin(pin));
+  debounce_port_t* debounce_port = &this->ports[getSilabsPortFromArduinoPin(pin)];
+  if (!(debounce_port->button_mask & pin_mask)) {
+    return false;
+  }
+  return (debounce_port->level ^ debounce_port->active_low_mask) & pin_mask;
+}
+
+void DebouncerClass::set_sample_period(uint32_t period_ms)
+{
+  if (period_ms == 0u) {
+    return;
+  }
+  this->sample_period_ms = period_ms;
+  if (this->sampling) {
+    this->stop_sampling();
+    this->start_sampling();
+  }
+}
+
+void DebouncerClass::set_long_press_time(uint32_t time_ms)
+{
+  this->long_press_time_ms = time_ms;
+}
+
+bool DebouncerClass::read_event(button_event_t& event)
+{
+  return this->event_queue.pop(event);
+}
+
+uint32_t DebouncerClass::events_available()
+{
+  return this->event_queue.available();
+}
+
+uint32_t DebouncerClass::get_overrun_count()
+{
+  return this->overrun_count;
+}
+
+void DebouncerClass::set_callback(button_event_callback_t callback)
+{
+  this->callback = callback;
+  // The events are delivered to the callback from the Arduino task
+  if (callback) {
+    register_arduino_task_hook(&debouncer_task_hook);
+  }
+}
+
+void DebouncerClass::task()
+{
+  if (!this->callback) {
+    return;
+  }
+  button_event_t event;
+  while (this->event_queue.pop(event)) {
+    this->callback(event);
+  }
+}
+
+void DebouncerClass::start_sampling()
+{
+  if (this->sampling) {
+    return;
+  }
+  sl_status_t status = sl_sleeptimer_start_periodic_timer_ms(&this->sample_timer,
+                                                             this->sample_period_ms,
+                                                             &DebouncerClass::sample_timer_callback,
+                                                             this,
+                                                             0u,
+                                                             0u);
+  this->sampling = (status == SL_STATUS_OK);
+}
+
+void DebouncerClass::stop_sampling()
+{
+  if (!this->sampling) {
+    return;
+  }
+  sl_sleeptimer_stop_timer(&this->sample_timer);
+  this->sampling = false;
+}
+
+void DebouncerClass::sample_timer_callback(sl_sleeptimer_timer_handle_t* handle, void* data)
+{
+  (void)handle;
+  static_cast<DebouncerClass*>(data)->sample();
+}
+
+void DebouncerClass::sample()
+{
+  this->sample_count++;
+  uint32_t long_press_samples = this->long_press_time_ms / this->sample_period_ms;
+
+  for (uint8_t port = 0u; port < num_ports; port++) {
+    debounce_port_t* debounce_port = &this->ports[port];
+    if (!debounce_port->button_mask) {
+      continue;
+    }
+
+    // Debounce all pins of the port at once with a 2 bit vertical counter per pin
+    // A pin's level changes after it differed from the debounced level for four samples in a row
+    uint16_t delta = (uint16_t)((GPIO->P[port].DIN ^ debounce_port->level) & debounce_port->button_mask);
+    debounce_port->count1 = (uint16_t)((debounce_port->count1 ^ debounce_port->count0) & delta);
+    debounce_port->count0 = (uint16_t)(~debounce_port->count0 & delta);
+    uint16_t changed = (uint16_t)(delta & ~(debounce_port->count0 | debounce_port->count1));
+    debounce_port->level ^= changed;
+    uint16_t pressed = (uint16_t)(debounce_port->level ^ debounce_port->active_low_mask);
+
+    // Report the changed pins
+    while (changed) {
+      uint8_t port_pin = (uint8_t)__builtin_ctz(changed);
+      uint16_t pin_mask = (uint16_t)(1u << port_pin);
+      changed &= (uint16_t)~pin_mask;
+      PinName pin = (PinName)(PIN_NAME_MIN + port * pins_per_port + port_pin);
+      if (pressed & pin_mask) {
+        this->press_sample[port][port_pin] = this->sample_count;
+        debounce_port->long_press_mask |= pin_mask;
+        this->post_event(pin, BUTTON_PRESSED);
+      } else {
+        debounce_port->long_press_mask &= (uint16_t)~pin_mask;
+        this->post_event(pin, BUTTON_RELEASED);
+      }
+    }
+
+    // Report the buttons held for the long press time
+    if (long_press_samples == 0u) {
+      continue;
+    }
+    uint16_t held = debounce_port->long_press_mask;
+    while (held) {
+      uint8_t port_pin = (uint8_t)__builtin_ctz(held);
+      uint16_t pin_mask = (uint16_t)(1u << port_pin);
+      held &= (uint16_t)~pin_mask;
+      if (this->sample_count - this->press_sample[port][port_pin] >= long_press_samples) {
+        debounce_port->long_press_mask &= (uint16_t)~pin_mask;
+        this->post_event((PinName)(PIN_NAME_MIN + port * pins_per_port + port_pin), BUTTON_LONG_PRESSED);
+      }
+    }
+  }
+}
+
+void DebouncerClass::post_event(PinName pin, button_event_type_t type)
+{
+  button_event_t event;
+  event.pin = pin;
+  event.type = type;
+  event.timestamp = millis();
+  if (!this->event_queue.push(event)) {
+    this->overrun_count = this->overrun_count + 1u;
+  }
+}
+
+arduino::DebouncerClass Debouncer;
@@ -0,0 +1,185 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef __ARDUINO_DEBOUNCER_H
+#define __ARDUINO_DEBOUNCER_H
+
+#include <inttypes.h>
+#include "pinDefinitions.h"
+#include "spsc_queue.h"
+#include "sl_sleeptimer.h"
+
+// Number of button events that can be buffered between the sampling timer and the Arduino task
+// Must be a power of two
+#ifndef DEBOUNCER_EVENT_QUEUE_SIZE
+#define DEBOUNCER_EVENT_QUEUE_SIZE 32
+#endif // DEBOUNCER_EVENT_QUEUE_SIZE
+
+typedef enum {
+  BUTTON_PRESSED,
+  BUTTON_RELEASED,
+  BUTTON_LONG_PRESSED
+} button_event_type_t;
+
+typedef struct {
+  PinName pin;               // The pin of the button
+  button_event_type_t type;  // The type of the event
+  uint32_t timestamp;        // The value of millis() when the event was detected
+} button_event_t;
+
+typedef void (*button_event_callback_t)(const button_event_t& event);
+
+namespace arduino {
+class DebouncerClass {
+public:
+  /***************************************************************************//**
+   * Constructor for DebouncerClass
+   ******************************************************************************/
+  DebouncerClass();
+
+  /***************************************************************************//**
+   * Adds a button to the debouncer
+   * Configures the pin as an input with a pull resistor towards the inactive
+   * state and starts sampling it. All buttons are sampled together from a low
+   * power timer, one register read per GPIO port, so the cost of a sample
+   * doesn't depend on the number of buttons. A state change is accepted after
+   * four consecutive identical samples.
+   *
+   * @param[in] pin the pin of the button
+   * @param[in] active_state the state of the pin when the button is pressed (LOW or HIGH)
+   *
+   * @return true if the button was added, false if the pin is invalid
+   ******************************************************************************/
+  bool add_button(pin_size_t pin, PinStatus active_state = LOW);
+  bool add_button(PinName pin, PinStatus active_state = LOW);
+
+  /***************************************************************************//**
+   * Removes a button from the debouncer
+   *
+   * @param[in] pin the pin of the button
+   ******************************************************************************/
+  void remove_button(pin_size_t pin);
+  void remove_button(PinName pin);
+
+  /***************************************************************************//**
+   * Returns the debounced state of a button
+   *
+   * @param[in] pin the pin of the button
+   *
+   * @return true if the button is pressed, false otherwise
+   ******************************************************************************/
+  bool is_pressed(pin_size_t pin);
+  bool is_pressed(PinName pin);
+
+  /***************************************************************************//**
+   * Sets the sampling period - the default is 5 ms (20 ms to settle)
+   *
+   * @param[in] period_ms the sampling period in milliseconds
+   ******************************************************************************/
+  void set_sample_period(uint32_t period_ms);
+
+  /***************************************************************************//**
+   * Sets how long a button has to be held for a long press event - the default is 1000 ms
+   *
+   * @param[in] time_ms the long press time in milliseconds, 0 disables long press events
+   ******************************************************************************/
+  void set_long_press_time(uint32_t time_ms);
+
+  /***************************************************************************//**
+   * Reads the oldest button event
+   * Must not be used together with an event callback.
+   *
+   * @param[out] event the oldest button event
+   *
+   * @return true if an event was read, false if there are no events
+   ******************************************************************************/
+  bool read_event(button_event_t& event);
+
+  /***************************************************************************//**
+   * Returns the number of button events waiting to be read
+   *
+   * @return the number of button events waiting to be read
+   ******************************************************************************/
+  uint32_t events_available();
+
+  /***************************************************************************//**
+   * Returns the number of button events dropped because the queue was full
+   *
+   * @return the number of dropped button events
+   ******************************************************************************/
+  uint32_t get_overrun_count();
+
+  /***************************************************************************//**
+   * Sets a callback which is called from the Arduino task (after each loop())
+   * for every button event. Pass nullptr to read the events manually.
+   *
+   * @param[in] callback the callback to call for every button event
+   ******************************************************************************/
+  void set_callback(button_event_callback_t callback);
+
+  /***************************************************************************//**
+   * Delivers the button events to the callback - called by the Arduino task
+   ******************************************************************************/
+  void task();
+
+private:
+  static void sample_timer_callback(sl_sleeptimer_timer_handle_t* handle, void* data);
+  void sample();
+  void post_event(PinName pin, button_event_type_t type);
+  void start_sampling();
+  void stop_sampling();
+
+  static const uint8_t num_ports = 4u;
+  static const uint8_t pins_per_port = 16u;
+
+  typedef struct {
+    uint16_t button_mask;       // Registered buttons
+    uint16_t active_low_mask;   // Buttons which are pressed when the pin is LOW
+    uint16_t level;             // Debounced pin levels
+    uint16_t count0;            // Vertical counter bit 0 (one bit per pin)
+    uint16_t count1;            // Vertical counter bit 1 (one bit per pin)
+    uint16_t long_press_mask;   // Pressed buttons which haven't been reported as long pressed yet
+  } debounce_port_t;
+
+  debounce_port_t ports[num_ports];
+  uint32_t press_sample[num_ports][pins_per_port];
+  uint32_t sample_count;
+  uint32_t sample_period_ms;
+  uint32_t long_press_time_ms;
+  bool sampling;
+
+  sl_sleeptimer_timer_handle_t sample_timer;
+  SpscQueue<button_event_t, DEBOUNCER_EVENT_QUEUE_SIZE> event_queue;
+  volatile uint32_t overrun_count;
+  button_event_callback_t callback;
+};
+} // namespace arduino
+
+extern arduino::DebouncerClass Debouncer;
+
+#endif // __ARDUINO_DEBOUNCER_H
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "fast_gpio.h"
+
+using namespace arduino;
+
+FastPin::FastPin(pin_size_t pin) :
+  FastPin(pinToPinName(pin))
+{
+  ;
+}
+
+FastPin::FastPin(PinName pin) :
+  dout_set(&GPIO->P_SET[gpioPortA].DOUT),
+  dout_clr(&GPIO->P_CLR[gpioPortA].DOUT),
+  dout_tgl(&GPIO->P_TGL[gpioPortA].DOUT),
+  din(&GPIO->P[gpioPortA].DIN),
+  mask(0u)
+{
+  // Invalid pins keep a zero mask - writing zero to the set/clear/toggle registers has no effect
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX) {
+    return;
+  }
+  GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(pin);
+  this->dout_set = &GPIO->P_SET[port].DOUT;
+  this->dout_clr = &GPIO->P_CLR[port].DOUT;
+  this->dout_tgl = &GPIO->P_TGL[port].DOUT;
+  this->din = &GPIO->P[port].DIN;
+  this->mask = 1UL << getSilabsPinFromArduinoPin(pin);
+}
+
+GPIO_Port_TypeDef digitalPinToGpioPort(pin_size_t pin)
+{
+  return digitalPinToGpioPort(pinToPinName(pin));
+}
+
+GPIO_Port_TypeDef digitalPinToGpioPort(PinName pin)
+{
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX) {
+    return gpioPortA;
+  }
+  return getSilabsPortFromArduinoPin(pin);
+}
+
+uint16_t digitalPinToPortMask(pin_size_t pin)
+{
+  return digitalPinToPortMask(pinToPinName(pin));
+}
+
+uint16_t digitalPinToPortMask(PinName pin)
+{
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX) {
+    return 0u;
+  }
+  return (uint16_t)(1u << getSilabsPinFromArduinoPin(pin));
+}
@@ -0,0 +1,292 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef __ARDUINO_FAST_GPIO_H
+#define __ARDUINO_FAST_GPIO_H
+
+#include <inttypes.h>
+#include "pinDefinitions.h"
+
+extern "C" {
+  #include "em_gpio.h"
+}
+
+namespace arduino {
+class FastPin {
+public:
+  /***************************************************************************//**
+   * Constructor for FastPin
+   * Resolves the Arduino pin to its GPIO port registers and bit mask once,
+   * so every later operation is a single register access.
+   * The pin mode is not changed - use pinMode() to configure the pin.
+   * If the pin is not valid all operations are no-ops and reads return LOW.
+   *
+   * @param[in] pin The Arduino pin number
+   ******************************************************************************/
+  FastPin(pin_size_t pin);
+
+  /***************************************************************************//**
+   * Constructor for FastPin
+   *
+   * @param[in] pin The pin name (PA0, PB1, etc.)
+   ******************************************************************************/
+  FastPin(PinName pin);
+
+  /***************************************************************************//**
+   * Drives the pin high
+   ******************************************************************************/
+  inline void set()
+  {
+    *this->dout_set = this->mask;
+  }
+
+  /***************************************************************************//**
+   * Drives the pin low
+   ******************************************************************************/
+  inline void clear()
+  {
+    *this->dout_clr = this->mask;
+  }
+
+  /***************************************************************************//**
+   * Inverts the current output state of the pin
+   ******************************************************************************/
+  inline void toggle()
+  {
+    *this->dout_tgl = this->mask;
+  }
+
+  /***************************************************************************//**
+   * Sets the output state of the pin
+   *
+   * @param[in] status the requested output state (HIGH or LOW)
+   ******************************************************************************/
+  inline void write(PinStatus status)
+  {
+    if (status == PinStatus::LOW) {
+      this->clear();
+    } else {
+      this->set();
+    }
+  }
+
+  /***************************************************************************//**
+   * Reads the input state of the pin
+   *
+   * @return the state of the pin (HIGH or LOW)
+   ******************************************************************************/
+  inline PinStatus read()
+  {
+    return (*this->din & this->mask) ? PinStatus::HIGH : PinStatus::LOW;
+  }
+
+  /***************************************************************************//**
+   * Returns whether the handle refers to a valid pin
+   *
+   * @return true if the pin is valid, false otherwise
+   ******************************************************************************/
+  inline bool is_valid()
+  {
+    return this->mask != 0u;
+  }
+
+private:
+  volatile uint32_t* dout_set;
+  volatile uint32_t* dout_clr;
+  volatile uint32_t* dout_tgl;
+  volatile const uint32_t* din;
+  uint32_t mask;
+};
+} // namespace arduino
+
+/***************************************************************************//**
+ * Converts an Arduino pin number to a PinName at compile time
+ * Same as pinToPinName(), but resolved from the variant's pin table by the
+ * compiler when called with a constant.
+ *
+ * @param[in] pin The Arduino pin number
+ *
+ * @return the corresponding PinName - PIN_NAME_NC if the pin is not valid
+ ******************************************************************************/
+constexpr PinName pinToPinNameConstexpr(pin_size_t pin)
+{
+  return (pin >= PIN_NAME_MIN && pin < PIN_NAME_MAX) ? (PinName)pin
+         : (pin < sizeof(ArduinoVariantPins::names) / sizeof(ArduinoVariantPins::names[0])) ? ArduinoVariantPins::names[pin]
+         : PIN_NAME_NC;
+}
+
+/***************************************************************************//**
+ * Sets the output state of a pin known at compile time
+ * The pin mapping is resolved by the compiler, so the call compiles to a
+ * single register store. Invalid pins are rejected at compile time.
+ * Usage: digitalWrite<D3>(HIGH);
+ *
+ * @param[in] status the requested output state (HIGH or LOW)
+ ******************************************************************************/
+template<pin_size_t pin>
+inline void digitalWrite(PinStatus status)
+{
+  static_assert(pinToPinNameConstexpr(pin) != PIN_NAME_NC, "Invalid pin");
+  constexpr GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(pinToPinNameConstexpr(pin));
+  constexpr uint32_t mask = 1UL << getSilabsPinFromArduinoPin(pinToPinNameConstexpr(pin));
+  if (status == PinStatus::LOW) {
+    GPIO->P_CLR[port].DOUT = mask;
+  } else {
+    GPIO->P_SET[port].DOUT = mask;
+  }
+}
+
+/***************************************************************************//**
+ * Reads the input state of a pin known at compile time
+ * Usage: PinStatus state = digitalRead<D3>();
+ *
+ * @return the state of the pin (HIGH or LOW)
+ ******************************************************************************/
+template<pin_size_t pin>
+inline PinStatus digitalRead()
+{
+  static_assert(pinToPinNameConstexpr(pin) != PIN_NAME_NC, "Invalid pin");
+  constexpr GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(pinToPinNameConstexpr(pin));
+  constexpr uint32_t mask = 1UL << getSilabsPinFromArduinoPin(pinToPinNameConstexpr(pin));
+  return (GPIO->P[port].DIN & mask) ? PinStatus::HIGH : PinStatus::LOW;
+}
+
+/***************************************************************************//**
+ * Inverts the output state of a pin known at compile time
+ * Usage: digitalToggle<D3>();
+ ******************************************************************************/
+template<pin_size_t pin>
+inline void digitalToggle()
+{
+  static_assert(pinToPinNameConstexpr(pin) != PIN_NAME_NC, "Invalid pin");
+  constexpr GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(pinToPinNameConstexpr(pin));
+  constexpr uint32_t mask = 1UL << getSilabsPinFromArduinoPin(pinToPinNameConstexpr(pin));
+  GPIO->P_TGL[port].DOUT = mask;
+}
+
+/***************************************************************************//**
+ * Returns the GPIO port of an Arduino pin
+ * Used together with digitalPinToPortMask() and the port functions below.
+ *
+ * @param[in] pin The Arduino pin number
+ *
+ * @return the GPIO port of the pin - gpioPortA if the pin is not valid
+ ******************************************************************************/
+GPIO_Port_TypeDef digitalPinToGpioPort(pin_size_t pin);
+GPIO_Port_TypeDef digitalPinToGpioPort(PinName pin);
+
+/***************************************************************************//**
+ * Returns the bit mask of an Arduino pin within its GPIO port
+ * Masks of pins on the same port can be combined with bitwise OR.
+ *
+ * @param[in] pin The Arduino pin number
+ *
+ * @return the bit mask of the pin - 0 if the pin is not valid
+ ******************************************************************************/
+uint16_t digitalPinToPortMask(pin_size_t pin);
+uint16_t digitalPinToPortMask(PinName pin);
+
+/***************************************************************************//**
+ * Sets the output state of multiple pins on a GPIO port at once
+ * All pins in 'mask' are updated with a single write of the port's output
+ * register, so their edges are simultaneous. Pins outside 'mask' are untouched.
+ *
+ * @param[in] port the GPIO port
+ * @param[in] mask the pins to update
+ * @param[in] value the requested output states for the pins in 'mask'
+ ******************************************************************************/
+inline void digitalWritePort(GPIO_Port_TypeDef port, uint16_t mask, uint16_t value)
+{
+  if (port > gpioPortD) {
+    return;
+  }
+  // The read-modify-write must not be interleaved with GPIO writes from interrupts
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  GPIO->P[port].DOUT = (GPIO->P[port].DOUT & ~(uint32_t)mask) | (value & mask);
+  __set_PRIMASK(primask);
+}
+
+/***************************************************************************//**
+ * Drives multiple pins on a GPIO port high with a single register access
+ *
+ * @param[in] port the GPIO port
+ * @param[in] mask the pins to drive high
+ ******************************************************************************/
+inline void digitalSetPort(GPIO_Port_TypeDef port, uint16_t mask)
+{
+  if (port > gpioPortD) {
+    return;
+  }
+  GPIO->P_SET[port].DOUT = mask;
+}
+
+/***************************************************************************//**
+ * Drives multiple pins on a GPIO port low with a single register access
+ *
+ * @param[in] port the GPIO port
+ * @param[in] mask the pins to drive low
+ ******************************************************************************/
+inline void digitalClearPort(GPIO_Port_TypeDef port, uint16_t mask)
+{
+  if (port > gpioPortD) {
+    return;
+  }
+  GPIO->P_CLR[port].DOUT = mask;
+}
+
+/***************************************************************************//**
+ * Inverts multiple pins on a GPIO port with a single register access
+ *
+ * @param[in] port the GPIO port
+ * @param[in] mask the pins to invert
+ ******************************************************************************/
+inline void digitalTogglePort(GPIO_Port_TypeDef port, uint16_t mask)
+{
+  if (port > gpioPortD) {
+    return;
+  }
+  GPIO->P_TGL[port].DOUT = mask;
+}
+
+/***************************************************************************//**
+ * Reads the input state of all pins on a GPIO port at once
+ *
+ * @param[in] port the GPIO port
+ *
+ * @return the input states of the port's pins - bit n is pin n
+ ******************************************************************************/
+inline uint16_t digitalReadPort(GPIO_Port_TypeDef port)
+{
+  if (port > gpioPortD) {
+    return 0u;
+  }
+  return (uint16_t)GPIO->P[port].DIN;
+}
+
+#endif // __ARDUINO_FAST_GPIO_H
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "gpio_events.h"
+#include "spsc_queue.h"
+
+using namespace arduino;
+
+static SpscQueue<gpio_event_t, GPIO_EVENT_QUEUE_SIZE> gpio_event_queue;
+static volatile uint32_t gpio_event_overrun_count = 0u;
+static gpio_event_callback_t gpio_event_callback = nullptr;
+
+void gpio_event_post(PinName pin, PinStatus edge)
+{
+  gpio_event_t event;
+  event.pin = pin;
+  event.edge = edge;
+  event.timestamp = micros();
+  if (!gpio_event_queue.push(event)) {
+    gpio_event_overrun_count = gpio_event_overrun_count + 1u;
+  }
+}
+
+void handle_gpio_events()
+{
+  if (!gpio_event_callback) {
+    return;
+  }
+  gpio_event_t event;
+  while (gpio_event_queue.pop(event)) {
+    gpio_event_callback(event);
+  }
+}
+
+bool readGpioEvent(gpio_event_t& event)
+{
+  return gpio_event_queue.pop(event);
+}
+
+uint32_t gpioEventsAvailable()
+{
+  return gpio_event_queue.available();
+}
+
+uint32_t getGpioEventOverrunCount()
+{
+  return gpio_event_overrun_count;
+}
+
+void setGpioEventCallback(gpio_event_callback_t callback)
+{
+  gpio_event_callback = callback;
+  // The events are delivered to the callback from the Arduino task
+  if (callback) {
+    register_arduino_task_hook(&handle_gpio_events);
+  }
+}
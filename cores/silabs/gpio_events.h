@@ -0,0 +1,100 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef __ARDUINO_GPIO_EVENTS_H
+#define __ARDUINO_GPIO_EVENTS_H
+
+#include <inttypes.h>
+#include "pinDefinitions.h"
+
+// Number of GPIO events that can be buffered between the interrupt and the Arduino task
+// Must be a power of two
+#ifndef GPIO_EVENT_QUEUE_SIZE
+#define GPIO_EVENT_QUEUE_SIZE 32
+#endif // GPIO_EVENT_QUEUE_SIZE
+
+typedef struct {
+  PinName pin;         // The pin which triggered the event
+  PinStatus edge;      // RISING or FALLING
+  uint32_t timestamp;  // The value of micros() when the interrupt occurred
+} gpio_event_t;
+
+typedef void (*gpio_event_callback_t)(const gpio_event_t& event);
+
+/***************************************************************************//**
+ * Attaches a deferred interrupt to a pin
+ * Instead of calling a callback in interrupt context each edge is recorded
+ * with a timestamp into a lock-free queue. The events can be read with
+ * readGpioEvent() or handled in the Arduino task by a callback set with
+ * setGpioEventCallback(). Use detachInterrupt() to stop generating events.
+ *
+ * @param[in] pin The Arduino pin number
+ * @param[in] mode The edge(s) to record (CHANGE, RISING, FALLING, HIGH, LOW)
+ ******************************************************************************/
+void attachInterruptEvent(pin_size_t pin, PinStatus mode);
+void attachInterruptEvent(PinName pin, PinStatus mode);
+
+/***************************************************************************//**
+ * Reads the oldest recorded GPIO event
+ * Must not be used together with an event callback.
+ *
+ * @param[out] event the oldest recorded event
+ *
+ * @return true if an event was read, false if there are no events
+ ******************************************************************************/
+bool readGpioEvent(gpio_event_t& event);
+
+/***************************************************************************//**
+ * Returns the number of recorded GPIO events waiting to be read
+ *
+ * @return the number of GPIO events waiting to be read
+ ******************************************************************************/
+uint32_t gpioEventsAvailable();
+
+/***************************************************************************//**
+ * Returns the number of GPIO events dropped because the queue was full
+ *
+ * @return the number of dropped GPIO events
+ ******************************************************************************/
+uint32_t getGpioEventOverrunCount();
+
+/***************************************************************************//**
+ * Sets a callback which is called from the Arduino task (after each loop())
+ * for every recorded GPIO event. Pass nullptr to read the events manually.
+ *
+ * @param[in] callback the callback to call for every GPIO event
+ ******************************************************************************/
+void setGpioEventCallback(gpio_event_callback_t callback);
+
+// Called by the GPIO interrupt handler to record an event
+void gpio_event_post(PinName pin, PinStatus edge);
+
+// Called by the Arduino task to deliver the recorded events to the callback
+void handle_gpio_events();
+
+#endif // __ARDUINO_GPIO_EVENTS_H
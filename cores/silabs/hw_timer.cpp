@@ -0,0 +1,143 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "hw_timer.h"
+#include "em_core.h"
+
+typedef struct {
+  TIMER_TypeDef* timer;
+  CMU_Clock_TypeDef clock;
+  IRQn_Type irqn;
+  bool in_use;
+  hw_timer_irq_handler_t irq_handler;
+  void* irq_ctx;
+} hw_timer_t;
+
+// TIMER0 is used by the PWM driver (sl_pwm) - it's marked as in use permanently
+static hw_timer_t hw_timers[] = {
+  { TIMER0, cmuClock_TIMER0, TIMER0_IRQn, true, nullptr, nullptr },
+  { TIMER1, cmuClock_TIMER1, TIMER1_IRQn, false, nullptr, nullptr },
+  { TIMER2, cmuClock_TIMER2, TIMER2_IRQn, false, nullptr, nullptr },
+  { TIMER3, cmuClock_TIMER3, TIMER3_IRQn, false, nullptr, nullptr },
+  { TIMER4, cmuClock_TIMER4, TIMER4_IRQn, false, nullptr, nullptr }
+};
+
+static const uint8_t hw_timer_count = sizeof(hw_timers) / sizeof(hw_timers[0]);
+
+static hw_timer_t* get_hw_timer(TIMER_TypeDef* timer)
+{
+  for (uint8_t i = 0; i < hw_timer_count; i++) {
+    if (hw_timers[i].timer == timer) {
+      return &hw_timers[i];
+    }
+  }
+  return nullptr;
+}
+
+TIMER_TypeDef* hw_timer_allocate()
+{
+  TIMER_TypeDef* allocated_timer = nullptr;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  for (uint8_t i = 0; i < hw_timer_count; i++) {
+    if (!hw_timers[i].in_use) {
+      hw_timers[i].in_use = true;
+      allocated_timer = hw_timers[i].timer;
+      break;
+    }
+  }
+  CORE_EXIT_ATOMIC();
+
+  if (allocated_timer) {
+    CMU_ClockEnable(hw_timer_get_clock(allocated_timer), true);
+  }
+  return allocated_timer;
+}
+
+void hw_timer_free(TIMER_TypeDef* timer)
+{
+  hw_timer_t* hw_timer = get_hw_timer(timer);
+  if (!hw_timer || hw_timer->timer == TIMER0 || !hw_timer->in_use) {
+    return;
+  }
+  hw_timer_set_irq_handler(timer, nullptr, nullptr);
+  TIMER_Reset(timer);
+  CMU_ClockEnable(hw_timer->clock, false);
+  hw_timer->in_use = false;
+}
+
+CMU_Clock_TypeDef hw_timer_get_clock(TIMER_TypeDef* timer)
+{
+  hw_timer_t* hw_timer = get_hw_timer(timer);
+  if (!hw_timer) {
+    return cmuClock_TIMER0;
+  }
+  return hw_timer->clock;
+}
+
+void hw_timer_set_irq_handler(TIMER_TypeDef* timer, hw_timer_irq_handler_t handler, void* ctx)
+{
+  hw_timer_t* hw_timer = get_hw_timer(timer);
+  if (!hw_timer || hw_timer->timer == TIMER0) {
+    return;
+  }
+  NVIC_DisableIRQ(hw_timer->irqn);
+  hw_timer->irq_handler = handler;
+  hw_timer->irq_ctx = ctx;
+  if (handler) {
+    NVIC_ClearPendingIRQ(hw_timer->irqn);
+    NVIC_EnableIRQ(hw_timer->irqn);
+  }
+}
+
+static void hw_timer_irq(hw_timer_t* hw_timer)
+{
+  if (hw_timer->irq_handler) {
+    hw_timer->irq_handler(hw_timer->timer, hw_timer->irq_ctx);
+  } else {
+    TIMER_IntClear(hw_timer->timer, _TIMER_IF_MASK);
+  }
+}
+
+void TIMER1_IRQHandler(void)
+{
+  hw_timer_irq(&hw_timers[1]);
+}
+
+void TIMER2_IRQHandler(void)
+{
+  hw_timer_irq(&hw_timers[2]);
+}
+
+void TIMER3_IRQHandler(void)
+{
+  hw_timer_irq(&hw_timers[3]);
+}
+
+void TIMER4_IRQHandler(void)
+{
+  hw_timer_irq(&hw_timers[4]);
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef __ARDUINO_HW_TIMER_H
+#define __ARDUINO_HW_TIMER_H
+
+#include <inttypes.h>
+#include "em_timer.h"
+#include "em_cmu.h"
+
+typedef void (*hw_timer_irq_handler_t)(TIMER_TypeDef* timer, void* ctx);
+
+/***************************************************************************//**
+ * Allocates a free TIMER peripheral for exclusive use
+ * TIMER0 is reserved for the PWM driver and is never returned.
+ *
+ * @return the allocated TIMER, nullptr if all TIMERs are in use
+ ******************************************************************************/
+TIMER_TypeDef* hw_timer_allocate();
+
+/***************************************************************************//**
+ * Releases a TIMER allocated with hw_timer_allocate()
+ * Resets the TIMER, disables its interrupt and removes its IRQ handler.
+ *
+ * @param[in] timer the TIMER to release
+ ******************************************************************************/
+void hw_timer_free(TIMER_TypeDef* timer);
+
+/***************************************************************************//**
+ * Returns the CMU clock of a TIMER
+ *
+ * @param[in] timer the TIMER
+ *
+ * @return the CMU clock of the TIMER
+ ******************************************************************************/
+CMU_Clock_TypeDef hw_timer_get_clock(TIMER_TypeDef* timer);
+
+/***************************************************************************//**
+ * Sets the handler called from the interrupt of an allocated TIMER
+ * Also enables the TIMER interrupt in the NVIC (or disables it if the handler is nullptr).
+ *
+ * @param[in] timer the allocated TIMER
+ * @param[in] handler the handler to call in interrupt context
+ * @param[in] ctx the context passed to the handler
+ ******************************************************************************/
+void hw_timer_set_irq_handler(TIMER_TypeDef* timer, hw_timer_irq_handler_t handler, void* ctx);
+
+#endif // __ARDUINO_HW_TIMER_H
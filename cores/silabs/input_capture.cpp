@@ -0,0 +1,302 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "input_capture.h"
+#include "em_core.h"
+
+using namespace arduino;
+
+// The number of captures each channel can buffer in hardware
+static const uint8_t capture_fifo_size = 2u;
+
+InputCapture::InputCapture() :
+  timer(nullptr),
+  capturing(false),
+  tick_frequency(0u),
+  counter_range(0u),
+  overflow_ticks(0u),
+  last_rise(0u),
+  last_fall(0u),
+  last_rise_valid(false),
+  last_fall_valid(false),
+  high_ticks(0u),
+  low_ticks(0u),
+  period_ticks(0u),
+  high_ticks_new(false),
+  low_ticks_new(false),
+  period_ticks_new(false)
+{
+  ;
+}
+
+InputCapture::~InputCapture()
+{
+  this->end();
+}
+
+bool InputCapture::begin(pin_size_t pin)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return false;
+  }
+  return this->begin(pin_name);
+}
+
+bool InputCapture::begin(PinName pin)
+{
+  if (pin < PIN_NAME_MIN || pin >= PIN_NAME_MAX) {
+    return false;
+  }
+  this->suspend();
+
+  // Keep the TIMER of a suspended capture
+  if (!this->timer) {
+    this->timer = hw_timer_allocate();
+    if (!this->timer) {
+      return false;
+    }
+  }
+
+  this->tick_frequency = CMU_ClockFreqGet(hw_timer_get_clock(this->timer));
+  this->counter_range = static_cast<uint64_t>(TIMER_MaxCount(this->timer)) + 1u;
+  this->overflow_ticks = 0u;
+  this->last_rise_valid = false;
+  this->last_fall_valid = false;
+  this->high_ticks_new = false;
+  this->low_ticks_new = false;
+  this->period_ticks_new = false;
+
+  // Free running up-counter
+  TIMER_Init_TypeDef timer_init = TIMER_INIT_DEFAULT;
+  timer_init.enable = false;
+  TIMER_Init(this->timer, &timer_init);
+  TIMER_TopSet(this->timer, TIMER_MaxCount(this->timer));
+
+  // Channel 0 captures the rising edges, channel 1 captures the falling edges of the same pin
+  TIMER_InitCC_TypeDef cc_init = TIMER_INITCC_DEFAULT;
+  cc_init.mode = timerCCModeCapture;
+  cc_init.eventCtrl = timerEventEveryEdge;
+  cc_init.edge = timerEdgeRising;
+  TIMER_InitCC(this->timer, 0, &cc_init);
+  cc_init.edge = timerEdgeFalling;
+  TIMER_InitCC(this->timer, 1, &cc_init);
+
+  // Route the pin to both capture inputs - capture inputs don't need the route to be enabled
+  uint32_t route = (static_cast<uint32_t>(getSilabsPortFromArduinoPin(pin)) << _GPIO_TIMER_CC0ROUTE_PORT_SHIFT)
+                   | (getSilabsPinFromArduinoPin(pin) << _GPIO_TIMER_CC0ROUTE_PIN_SHIFT);
+  unsigned int timer_num = TIMER_NUM(this->timer);
+  GPIO->TIMERROUTE[timer_num].CC0ROUTE = route;
+  GPIO->TIMERROUTE[timer_num].CC1ROUTE = route;
+
+  TIMER_IntClear(this->timer, _TIMER_IF_MASK);
+  TIMER_IntEnable(this->timer, TIMER_IEN_OF | TIMER_IEN_CC0 | TIMER_IEN_CC1);
+  hw_timer_set_irq_handler(this->timer, &InputCapture::irq_handler, this);
+
+  #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+  // Require at least EM1 to keep the timer peripheral running
+  sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+  #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+
+  this->capturing = true;
+  TIMER_Enable(this->timer, true);
+  return true;
+}
+
+void InputCapture::end()
+{
+  this->suspend();
+  if (!this->timer) {
+    return;
+  }
+  hw_timer_free(this->timer);
+  this->timer = nullptr;
+  this->tick_frequency = 0u;
+}
+
+void InputCapture::suspend()
+{
+  if (!this->capturing) {
+    return;
+  }
+  TIMER_Enable(this->timer, false);
+  TIMER_IntDisable(this->timer, _TIMER_IEN_MASK);
+  TIMER_IntClear(this->timer, _TIMER_IF_MASK);
+  this->capturing = false;
+
+  #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+  // Remove the energy mode requirement
+  sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+  #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+}
+
+bool InputCapture::is_running()
+{
+  return this->capturing;
+}
+
+bool InputCapture::read_pulse_ticks(PinStatus state, uint32_t& ticks)
+{
+  bool res = false;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  if (state == HIGH && this->high_ticks_new) {
+    ticks = this->high_ticks;
+    this->high_ticks_new = false;
+    res = true;
+  } else if (state == LOW && this->low_ticks_new) {
+    ticks = this->low_ticks;
+    this->low_ticks_new = false;
+    res = true;
+  }
+  CORE_EXIT_ATOMIC();
+  return res;
+}
+
+bool InputCapture::read_period_ticks(uint32_t& ticks)
+{
+  bool res = false;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  if (this->period_ticks_new) {
+    ticks = this->period_ticks;
+    this->period_ticks_new = false;
+    res = true;
+  }
+  CORE_EXIT_ATOMIC();
+  return res;
+}
+
+uint32_t InputCapture::get_tick_frequency()
+{
+  return this->tick_frequency;
+}
+
+uint32_t InputCapture::ticks_to_us(uint32_t ticks)
+{
+  if (this->tick_frequency == 0u) {
+    return 0u;
+  }
+  return static_cast<uint32_t>(static_cast<uint64_t>(ticks) * 1000000u / this->tick_frequency);
+}
+
+uint64_t InputCapture::ticks_to_ns(uint32_t ticks)
+{
+  if (this->tick_frequency == 0u) {
+    return 0u;
+  }
+  return static_cast<uint64_t>(ticks) * 1000000000u / this->tick_frequency;
+}
+
+void InputCapture::irq_handler(TIMER_TypeDef* timer, void* ctx)
+{
+  (void)timer;
+  static_cast<InputCapture*>(ctx)->handle_irq();
+}
+
+void InputCapture::handle_irq()
+{
+  // Clear the capture flags before draining the FIFOs - captures arriving after this will raise a new interrupt
+  uint32_t flags = TIMER_IntGet(this->timer);
+  TIMER_IntClear(this->timer, flags & ~TIMER_IF_OF);
+
+  uint32_t rise_captures[capture_fifo_size];
+  uint32_t fall_captures[capture_fifo_size];
+  uint8_t rise_count = 0u;
+  uint8_t fall_count = 0u;
+  while (rise_count < capture_fifo_size && !(this->timer->STATUS & TIMER_STATUS_ICFEMPTY0)) {
+    rise_captures[rise_count++] = this->timer->CC[0].ICF;
+  }
+  while (fall_count < capture_fifo_size && !(this->timer->STATUS & TIMER_STATUS_ICFEMPTY1)) {
+    fall_captures[fall_count++] = this->timer->CC[1].ICF;
+  }
+
+  // Check for overflow after the captures were read, so that every capture taken after the overflow is accounted for
+  bool overflow_pending = TIMER_IntGet(this->timer) & TIMER_IF_OF;
+  if (overflow_pending) {
+    TIMER_IntClear(this->timer, TIMER_IF_OF);
+  }
+
+  // Process the edges in chronological order
+  uint8_t rise_idx = 0u;
+  uint8_t fall_idx = 0u;
+  while (rise_idx < rise_count || fall_idx < fall_count) {
+    uint64_t rise_timestamp = 0u;
+    uint64_t fall_timestamp = 0u;
+    if (rise_idx < rise_count) {
+      rise_timestamp = this->extend_capture(rise_captures[rise_idx], overflow_pending);
+    }
+    if (fall_idx < fall_count) {
+      fall_timestamp = this->extend_capture(fall_captures[fall_idx], overflow_pending);
+    }
+    if (fall_idx >= fall_count || (rise_idx < rise_count && rise_timestamp <= fall_timestamp)) {
+      this->handle_edge(rise_timestamp, true);
+      rise_idx++;
+    } else {
+      this->handle_edge(fall_timestamp, false);
+      fall_idx++;
+    }
+  }
+
+  if (overflow_pending) {
+    this->overflow_ticks += this->counter_range;
+  }
+}
+
+uint64_t InputCapture::extend_capture(uint32_t capture, bool overflow_pending)
+{
+  // If an overflow is pending then small capture values were taken after it, large ones before it
+  if (overflow_pending && capture < (this->counter_range / 2u)) {
+    return this->overflow_ticks + this->counter_range + capture;
+  }
+  return this->overflow_ticks + capture;
+}
+
+void InputCapture::handle_edge(uint64_t timestamp, bool rising)
+{
+  if (rising) {
+    if (this->last_fall_valid) {
+      uint64_t ticks = timestamp - this->last_fall;
+      this->low_ticks = (ticks > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(ticks);
+      this->low_ticks_new = true;
+    }
+    if (this->last_rise_valid) {
+      uint64_t ticks = timestamp - this->last_rise;
+      this->period_ticks = (ticks > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(ticks);
+      this->period_ticks_new = true;
+    }
+    this->last_rise = timestamp;
+    this->last_rise_valid = true;
+  } else {
+    if (this->last_rise_valid) {
+      uint64_t ticks = timestamp - this->last_rise;
+      this->high_ticks = (ticks > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(ticks);
+      this->high_ticks_new = true;
+    }
+    this->last_fall = timestamp;
+    this->last_fall_valid = true;
+  }
+}
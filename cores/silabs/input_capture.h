@@ -0,0 +1,150 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef __ARDUINO_INPUT_CAPTURE_H
+#define __ARDUINO_INPUT_CAPTURE_H
+
+#include <inttypes.h>
+#include "pinDefinitions.h"
+#include "hw_timer.h"
+
+namespace arduino {
+/***************************************************************************//**
+ * Hardware input capture on a GPIO pin
+ * Allocates a free TIMER and captures the timer value on every rising and
+ * falling edge of the pin in hardware. The high time, low time and period of
+ * the signal are measured at the TIMER clock resolution (the HF clock, e.g. 39 MHz)
+ * independent of the CPU load. Measurements are continuous and can be read
+ * without blocking. The pin has to be configured as an input with pinMode().
+ * The TIMER does not run in EM2, so EM1 is required while capturing.
+ ******************************************************************************/
+class InputCapture {
+public:
+  InputCapture();
+  ~InputCapture();
+
+  /***************************************************************************//**
+   * Starts capturing the edges of a pin
+   * Reuses the TIMER if it's still held from a previous capture (see suspend()).
+   *
+   * @param[in] pin the pin to capture
+   *
+   * @return true if capturing started, false if the pin is invalid or there are no free TIMERs
+   ******************************************************************************/
+  bool begin(pin_size_t pin);
+  bool begin(PinName pin);
+
+  /***************************************************************************//**
+   * Stops capturing and releases the TIMER
+   ******************************************************************************/
+  void end();
+
+  /***************************************************************************//**
+   * Stops capturing but keeps the TIMER allocated for the next begin()
+   * The TIMER is stopped and the EM1 requirement is removed while suspended.
+   ******************************************************************************/
+  void suspend();
+
+  /***************************************************************************//**
+   * Returns whether capturing is running
+   *
+   * @return true if capturing is running, false otherwise
+   ******************************************************************************/
+  bool is_running();
+
+  /***************************************************************************//**
+   * Reads the length of the latest pulse if it wasn't read before
+   *
+   * @param[in] state the state of the pulse - HIGH or LOW
+   * @param[out] ticks the length of the pulse in TIMER ticks
+   *
+   * @return true if a new pulse was measured since the last read, false otherwise
+   ******************************************************************************/
+  bool read_pulse_ticks(PinStatus state, uint32_t& ticks);
+
+  /***************************************************************************//**
+   * Reads the latest period (rising edge to rising edge) if it wasn't read before
+   *
+   * @param[out] ticks the length of the period in TIMER ticks
+   *
+   * @return true if a new period was measured since the last read, false otherwise
+   ******************************************************************************/
+  bool read_period_ticks(uint32_t& ticks);
+
+  /***************************************************************************//**
+   * Returns the frequency of the TIMER ticks
+   *
+   * @return the frequency of the TIMER ticks in hertz, 0 if capturing is not running
+   ******************************************************************************/
+  uint32_t get_tick_frequency();
+
+  /***************************************************************************//**
+   * Converts TIMER ticks to microseconds
+   *
+   * @param[in] ticks the number of TIMER ticks
+   *
+   * @return the duration in microseconds
+   ******************************************************************************/
+  uint32_t ticks_to_us(uint32_t ticks);
+
+  /***************************************************************************//**
+   * Converts TIMER ticks to nanoseconds
+   *
+   * @param[in] ticks the number of TIMER ticks
+   *
+   * @return the duration in nanoseconds
+   ******************************************************************************/
+  uint64_t ticks_to_ns(uint32_t ticks);
+
+private:
+  static void irq_handler(TIMER_TypeDef* timer, void* ctx);
+  void handle_irq();
+  void handle_edge(uint64_t timestamp, bool rising);
+  uint64_t extend_capture(uint32_t capture, bool overflow_pending);
+
+  TIMER_TypeDef* timer;
+  bool capturing;
+  uint32_t tick_frequency;
+  uint64_t counter_range;
+
+  uint64_t overflow_ticks;
+  uint64_t last_rise;
+  uint64_t last_fall;
+  bool last_rise_valid;
+  bool last_fall_valid;
+
+  volatile uint32_t high_ticks;
+  volatile uint32_t low_ticks;
+  volatile uint32_t period_ticks;
+  volatile bool high_ticks_new;
+  volatile bool low_ticks_new;
+  volatile bool period_ticks_new;
+};
+} // namespace arduino
+
+#endif // __ARDUINO_INPUT_CAPTURE_H
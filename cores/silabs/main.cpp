@@ -25,9 +25,11 @@
  */
 
 #include "Arduino.h"
+#include "em_core.h"
 
 void arduino_task(void *p_arg);
 inline static void handle_serial_events();
+inline static void run_arduino_task_hooks();
 static const uint32_t arduino_task_stack_size = ARDUINO_MAIN_TASK_STACK_SIZE;
 static const uint32_t arduino_task_priority = 1u;
 static StackType_t arduino_task_stack[arduino_task_stack_size] = { 0 };
@@ -35,6 +37,8 @@ static StaticTask_t arduino_task_buffer;
 static TaskHandle_t arduino_task_handle;
 static bool system_init_finished = false;
 static uint32_t system_reset_cause = 0u;
+static arduino_task_hook_t arduino_task_hooks[ARDUINO_TASK_HOOKS_MAX];
+static volatile uint8_t arduino_task_hook_count = 0u;
 
 int main()
 {
@@ -48,6 +52,7 @@ int main()
   // Board specific init - in most cases it's just a call to sl_system_init(),
   // but when using the Matter stack it needs a more complex init process
   init_arduino_variant();
+  init_hires_clock();
   system_init_finished = true;
 
   escape_hatch();
@@ -72,6 +77,7 @@ void arduino_task(void *p_arg)
   while (1) {
     loop();
     handle_serial_events();
+    run_arduino_task_hooks();
     taskYIELD();
   }
 }
@@ -87,6 +93,38 @@ inline static void handle_serial_events()
   #endif // #if (NUM_HW_SERIAL > 1)
 }
 
+inline static void run_arduino_task_hooks()
+{
+  uint8_t hook_count = arduino_task_hook_count;
+  for (uint8_t i = 0; i < hook_count; i++) {
+    arduino_task_hooks[i]();
+  }
+}
+
+bool register_arduino_task_hook(arduino_task_hook_t hook)
+{
+  if (hook == nullptr) {
+    return false;
+  }
+  bool registered = false;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  for (uint8_t i = 0; i < arduino_task_hook_count; i++) {
+    if (arduino_task_hooks[i] == hook) {
+      registered = true;
+      break;
+    }
+  }
+  if (!registered && arduino_task_hook_count < ARDUINO_TASK_HOOKS_MAX) {
+    // The hook is in place before the Arduino task can see the new count
+    arduino_task_hooks[arduino_task_hook_count] = hook;
+    arduino_task_hook_count = arduino_task_hook_count + 1u;
+    registered = true;
+  }
+  CORE_EXIT_ATOMIC();
+  return registered;
+}
+
 bool get_system_init_finished()
 {
   return system_init_finished;
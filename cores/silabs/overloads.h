@@ -30,6 +30,8 @@ unsigned long pulseIn(PinName pin, uint8_t state, unsigned long timeout);
 unsigned long pulseInLong(PinName pin, uint8_t state, unsigned long timeout);
 
 void shiftOut(PinName dataPin, PinName clockPin, BitOrder bitOrder, uint8_t val);
+void shiftOut(pin_size_t dataPin, pin_size_t clockPin, BitOrder bitOrder, const uint8_t* buf, size_t len);
+void shiftOut(PinName dataPin, PinName clockPin, BitOrder bitOrder, const uint8_t* buf, size_t len);
 uint8_t shiftIn(PinName dataPin, PinName clockPin, BitOrder bitOrder);
 
 void attachInterrupt(PinName interruptNumber, voidFuncPtr callback, PinStatus mode);
@@ -121,7 +121,18 @@ enum _dac_channel_t {
 PinName pinToPinName(pin_size_t pin);
 pin_size_t digitalPinToInterrupt(pin_size_t pin);
 
-GPIO_Port_TypeDef getSilabsPortFromArduinoPin(PinName pin_name);
-uint32_t getSilabsPinFromArduinoPin(PinName pin_name);
+// The port and pin lookups are constexpr so that calls with a constant pin fold to a constant
+constexpr GPIO_Port_TypeDef getSilabsPortFromArduinoPin(PinName pin_name)
+{
+  return (pin_name >= PD0) ? gpioPortD
+         : (pin_name >= PC0) ? gpioPortC
+         : (pin_name >= PB0) ? gpioPortB
+         : gpioPortA;
+}
+
+constexpr uint32_t getSilabsPinFromArduinoPin(PinName pin_name)
+{
+  return (pin_name - PIN_NAME_MIN) % 16;
+}
 
 #endif // PIN_DEFINITIONS_H
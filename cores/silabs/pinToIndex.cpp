@@ -37,7 +37,7 @@ PinName pinToPinName(pin_size_t pin)
   if (pin >= PINS_COUNT) {
     return PIN_NAME_NC;
   }
-  return gPinNames[pin];
+  return ArduinoVariantPins::names[pin];
 }
 
 pin_size_t digitalPinToInterrupt(pin_size_t pin)
@@ -46,20 +46,3 @@ pin_size_t digitalPinToInterrupt(pin_size_t pin)
   // This function is only here for compatibility
   return pin;
 }
-
-GPIO_Port_TypeDef getSilabsPortFromArduinoPin(PinName pin_name)
-{
-  if (pin_name >= PD0) {
-    return gpioPortD;
-  } else if (pin_name >= PC0) {
-    return gpioPortC;
-  } else if (pin_name >= PB0) {
-    return gpioPortB;
-  }
-  return gpioPortA;
-}
-
-uint32_t getSilabsPinFromArduinoPin(PinName pin_name)
-{
-  return (pin_name - PIN_NAME_MIN) % 16;
-}
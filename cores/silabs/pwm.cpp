@@ -25,24 +25,118 @@
  */
 
 #include "pwm.h"
+#include "hw_timer.h"
+#include "em_core.h"
 
 using namespace arduino;
 
+static void pwm_task_hook()
+{
+  PWM.task();
+}
+
+// Gamma 2.2 curve in 65 points from 0 to 65535 - interpolated linearly in between
+static const uint16_t pwm_gamma_table[] = {
+  0u, 7u, 32u, 78u, 147u, 240u, 359u, 504u,
+  676u, 875u, 1104u, 1361u, 1648u, 1966u, 2314u, 2693u,
+  3104u, 3547u, 4022u, 4530u, 5072u, 5646u, 6255u, 6897u,
+  7574u, 8286u, 9033u, 9815u, 10632u, 11486u, 12375u, 13301u,
+  14263u, 15262u, 16298u, 17371u, 18482u, 19630u, 20816u, 22040u,
+  23303u, 24604u, 25943u, 27322u, 28739u, 30196u, 31692u, 33227u,
+  34802u, 36417u, 38072u, 39768u, 41503u, 43280u, 45097u, 46954u,
+  48853u, 50793u, 52774u, 54796u, 56860u, 58966u, 61114u, 63303u,
+  65535u
+};
+
+static uint32_t apply_gamma(uint32_t level)
+{
+  uint32_t idx = level >> 10;
+  uint32_t fraction = level & 0x3FFu;
+  uint32_t low = pwm_gamma_table[idx];
+  uint32_t high = pwm_gamma_table[idx + 1u];
+  return low + (((high - low) * fraction) >> 10);
+}
+
+static bool get_timer_dma_signal(TIMER_TypeDef* timer, DMADRV_PeripheralSignal_t& dma_signal)
+{
+  if (timer == TIMER0) {
+    dma_signal = (DMADRV_PeripheralSignal_t)(LDMAXBAR_CH_REQSEL_SIGSEL_TIMER0UFOF | LDMAXBAR_CH_REQSEL_SOURCESEL_TIMER0);
+  } else if (timer == TIMER1) {
+    dma_signal = (DMADRV_PeripheralSignal_t)(LDMAXBAR_CH_REQSEL_SIGSEL_TIMER1UFOF | LDMAXBAR_CH_REQSEL_SOURCESEL_TIMER1);
+  } else if (timer == TIMER2) {
+    dma_signal = (DMADRV_PeripheralSignal_t)(LDMAXBAR_CH_REQSEL_SIGSEL_TIMER2UFOF | LDMAXBAR_CH_REQSEL_SOURCESEL_TIMER2);
+  } else if (timer == TIMER3) {
+    dma_signal = (DMADRV_PeripheralSignal_t)(LDMAXBAR_CH_REQSEL_SIGSEL_TIMER3UFOF | LDMAXBAR_CH_REQSEL_SOURCESEL_TIMER3);
+  } else if (timer == TIMER4) {
+    dma_signal = (DMADRV_PeripheralSignal_t)(LDMAXBAR_CH_REQSEL_SIGSEL_TIMER4UFOF | LDMAXBAR_CH_REQSEL_SOURCESEL_TIMER4);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static uint32_t timer_get_prescaler(TIMER_TypeDef* timer)
+{
+  return ((timer->CFG & _TIMER_CFG_PRESC_MASK) >> _TIMER_CFG_PRESC_SHIFT) + 1u;
+}
+
+static void timer_set_prescaler(TIMER_TypeDef* timer, uint32_t prescaler)
+{
+  // The configuration can only be changed while the TIMER is disabled - the counter is restarted afterwards
+  timer->EN_CLR = TIMER_EN_EN;
+  #if defined(TIMER_EN_DISABLING)
+  while (timer->EN & TIMER_EN_DISABLING) {
+  }
+  #endif
+  timer->CFG = (timer->CFG & ~_TIMER_CFG_PRESC_MASK) | ((prescaler - 1u) << _TIMER_CFG_PRESC_SHIFT);
+  timer->EN_SET = TIMER_EN_EN;
+}
+
+static void timer_enable_dma_clear_on_active(TIMER_TypeDef* timer)
+{
+  if (timer->CFG & TIMER_CFG_DMACLRACT) {
+    return;
+  }
+  // The configuration can only be changed while the TIMER is disabled
+  timer->EN_CLR = TIMER_EN_EN;
+  #if defined(TIMER_EN_DISABLING)
+  while (timer->EN & TIMER_EN_DISABLING) {
+  }
+  #endif
+  timer->CFG_SET = TIMER_CFG_DMACLRACT;
+  timer->EN_SET = TIMER_EN_EN;
+  timer->CMD = TIMER_CMD_START;
+}
+
 PwmClass::PwmClass() :
   pwm_mode(pwm_mode_t::DUTY_CYCLE),
   auto_deinit(true),
   pwm_mutex(nullptr),
-  duty_cycle_set_time(0u),
   duty_cycle_mode_write_resolution(8),
-  duty_cycle_mode_max_value(255)
+  duty_cycle_mode_max_value(255u),
+  tone_pin(PIN_NAME_MAX),
+  tone_playing(false),
+  tone_clock_freq(0u)
 {
   pwm_config = {
     .frequency = this->duty_cycle_mode_default_freq,
     .polarity  = PWM_ACTIVE_HIGH,
   };
 
+  for (auto& pwm_timer : pwm_timers) {
+    pwm_timer.timer = nullptr;
+    pwm_timer.frequency = 0;
+    pwm_timer.channel_mask = 0u;
+    pwm_timer.exclusive = false;
+  }
+
   for (auto& pwm_pin : pwm_pins) {
     pwm_pin.pin = PIN_NAME_MAX;
+    pwm_pin.timer_idx = 0u;
+    pwm_pin.sequence_running = false;
+    pwm_pin.sequence_looping = false;
+    pwm_pin.sequence_finished = false;
+    pwm_pin.sequence_dma_channel = 0u;
     pwm_pin.inst.timer = TIMER0;
     pwm_pin.inst.channel = 0;
     pwm_pin.inst.port = gpioPortA;
@@ -50,11 +144,17 @@ PwmClass::PwmClass() :
     pwm_pin.inst.location = 0;
   }
 
+  tone_inst.timer = TIMER0;
+  tone_inst.channel = 0;
+  tone_inst.port = gpioPortA;
+  tone_inst.pin = 0;
+  tone_inst.location = 0;
+
   this->pwm_mutex = xSemaphoreCreateMutexStatic(&this->pwm_mutex_buf);
   configASSERT(this->pwm_mutex);
 }
 
-bool PwmClass::init(PinName pin, int frequency)
+bool PwmClass::init(PinName pin, int frequency, bool exclusive)
 {
   uint8_t pwm_channel_idx = get_next_free_pwm_channel_idx();
   if (pwm_channel_idx == UINT8_MAX) {
@@ -62,38 +162,128 @@ bool PwmClass::init(PinName pin, int frequency)
     return false;
   }
 
-  #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
-  // Require at least EM1 to keep the timer peripheral running
-  sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
-  #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+  // Find a TIMER running at the requested frequency with a free CC channel
+  uint8_t timer_idx = this->allocate_pwm_timer(frequency, exclusive);
+  if (timer_idx == UINT8_MAX) {
+    return false;
+  }
+  pwm_timer_t* pwm_timer = &this->pwm_timers[timer_idx];
+  uint8_t cc_channel = 0u;
+  while (pwm_timer->channel_mask & (1u << cc_channel)) {
+    cc_channel++;
+  }
+  pwm_timer->channel_mask |= (1u << cc_channel);
 
   this->pwm_pins[pwm_channel_idx].pin = pin;
-  this->pwm_pins[pwm_channel_idx].duty_cycle_percent = 101;
+  this->pwm_pins[pwm_channel_idx].timer_idx = timer_idx;
+  this->pwm_pins[pwm_channel_idx].duty_cycle = -1;
+  this->pwm_pins[pwm_channel_idx].inst.timer = pwm_timer->timer;
   this->pwm_pins[pwm_channel_idx].inst.port = getSilabsPortFromArduinoPin(pin);
   this->pwm_pins[pwm_channel_idx].inst.pin = getSilabsPinFromArduinoPin(pin);
-  this->pwm_pins[pwm_channel_idx].inst.channel = pwm_channel_idx;
+  this->pwm_pins[pwm_channel_idx].inst.channel = cc_channel;
 
   GPIO_PinModeSet(this->pwm_pins[pwm_channel_idx].inst.port, this->pwm_pins[pwm_channel_idx].inst.pin, gpioModePushPull, 0);
   pwm_config.frequency = frequency;
   sl_pwm_init(&this->pwm_pins[pwm_channel_idx].inst, &pwm_config);
+  // Let the overflow DMA request of the TIMER drive sequences - the request is cleared when the LDMA serves it
+  timer_enable_dma_clear_on_active(pwm_timer->timer);
   sl_pwm_start(&this->pwm_pins[pwm_channel_idx].inst);
+
+  // sl_pwm_init() reinitializes the whole TIMER which drops the buffered compare values
+  // not yet latched by the other channels on it - reload them
+  for (auto& pwm_pin : this->pwm_pins) {
+    if (pwm_pin.pin == PIN_NAME_MAX || pwm_pin.pin == pin || pwm_pin.timer_idx != timer_idx || pwm_pin.duty_cycle < 0) {
+      continue;
+    }
+    uint32_t compare_value = this->calc_compare_value(pwm_pin.inst.timer, (uint32_t)pwm_pin.duty_cycle);
+    TIMER_CompareSet(pwm_pin.inst.timer, pwm_pin.inst.channel, compare_value);
+    TIMER_CompareBufSet(pwm_pin.inst.timer, pwm_pin.inst.channel, compare_value);
+  }
   return true;
 }
 
+uint8_t PwmClass::allocate_pwm_timer(int frequency, bool exclusive)
+{
+  // Share a TIMER which already runs at the same frequency
+  for (uint8_t i = 0; i < this->max_pwm_timers && !exclusive; i++) {
+    pwm_timer_t* pwm_timer = &this->pwm_timers[i];
+    if (pwm_timer->channel_mask == 0u || pwm_timer->exclusive || pwm_timer->frequency != frequency) {
+      continue;
+    }
+    uint8_t cc_num = (uint8_t)TIMER_CC_NUM(TIMER_NUM(pwm_timer->timer));
+    if (cc_num > this->max_pwm_channels_per_timer) {
+      cc_num = this->max_pwm_channels_per_timer;
+    }
+    if (pwm_timer->channel_mask != (1u << cc_num) - 1u) {
+      return i;
+    }
+  }
+
+  // Otherwise start using a new TIMER - TIMER0 is reserved for the PWM, the others are borrowed from the TIMER allocator
+  for (uint8_t i = 0; i < this->max_pwm_timers; i++) {
+    pwm_timer_t* pwm_timer = &this->pwm_timers[i];
+    if (pwm_timer->channel_mask != 0u) {
+      continue;
+    }
+    if (i == 0u) {
+      pwm_timer->timer = TIMER0;
+    } else {
+      pwm_timer->timer = hw_timer_allocate();
+      if (pwm_timer->timer == nullptr) {
+        // All TIMERs are in use
+        return UINT8_MAX;
+      }
+    }
+    pwm_timer->frequency = frequency;
+    pwm_timer->exclusive = exclusive;
+
+    #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+    // Require at least EM1 to keep the timer peripheral running
+    sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+    #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+    return i;
+  }
+  return UINT8_MAX;
+}
+
 void PwmClass::duty_cycle_mode(PinName pin, int duty_cycle)
 {
   if (duty_cycle < 0 || duty_cycle > (int)this->duty_cycle_mode_max_value || pin >= PIN_NAME_MAX) {
     return;
   }
 
-  // If the previous duty cycle setting was within the stabilization time - we wait for the stabilization time to elapse
-  // If different channels's duty cycles are set in quick succession they won't take effect - therefore we have to wait in between
-  while (millis() < this->duty_cycle_set_time + this->pwm_stabilization_time_ms) {
-    yield();
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+
+  uint8_t pwm_channel_idx = this->get_duty_cycle_mode_channel_idx(pin);
+  // Return if PWM could not be initialized
+  if (pwm_channel_idx == UINT8_MAX) {
+    xSemaphoreGive(this->pwm_mutex);
+    return;
   }
+  // Writing a duty cycle stops the sequence playing on the channel
+  this->stop_sequence_channel(&this->pwm_pins[pwm_channel_idx]);
 
-  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  // Don't change anything if the requested duty cycle is the same as the currently set
+  if (this->pwm_pins[pwm_channel_idx].duty_cycle == duty_cycle) {
+    xSemaphoreGive(this->pwm_mutex);
+    return;
+  }
+  this->pwm_pins[pwm_channel_idx].duty_cycle = duty_cycle;
+
+  // Stop the PWM on 0 duty cycle (if auto deinit is enabled), set the requested duty cycle otherwise
+  if (duty_cycle == 0 && this->auto_deinit) {
+    this->stop(pin);
+  } else {
+    sl_pwm_instance_t* inst = &this->pwm_pins[pwm_channel_idx].inst;
+    // The buffered compare value is latched at the next period - the update is glitch-free and takes no waiting
+    TIMER_CompareBufSet(inst->timer, inst->channel, this->calc_compare_value(inst->timer, (uint32_t)duty_cycle));
+  }
 
+  xSemaphoreGive(this->pwm_mutex);
+}
+
+uint8_t PwmClass::get_duty_cycle_mode_channel_idx(PinName pin)
+{
   // If the PWM was running in a different mode before - deinitialize it
   if (this->pwm_mode != pwm_mode_t::DUTY_CYCLE) {
     deinit_all_pwm_channels();
@@ -102,35 +292,160 @@ void PwmClass::duty_cycle_mode(PinName pin, int duty_cycle)
 
   // Initialize PWM if the pin doesn't have an initialized instance
   if (get_pwm_channel_idx_for_pin(pin) == UINT8_MAX) {
-    bool res = this->init(pin, this->duty_cycle_mode_default_freq);
-    // Return if PWM could not be initialized
-    if (!res) {
-      xSemaphoreGive(this->pwm_mutex);
-      return;
+    if (!this->init(pin, this->duty_cycle_mode_default_freq)) {
+      return UINT8_MAX;
     }
   }
-  // Calculate the duty cycle percent from the provided value
-  // Arduino passes the duty cycle as a number from 0 to the configured write resolution's max (255 by default).
-  // We need the duty cycle to be expressed as a number from 0-100.
-  int duty_cycle_percent = duty_cycle * 100 / this->duty_cycle_mode_max_value;
+  return get_pwm_channel_idx_for_pin(pin);
+}
 
-  uint8_t pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
-  // Don't change anything if the requested duty cycle is the same as the currently set
-  if (this->pwm_pins[pwm_channel_idx].duty_cycle_percent == (uint8_t)duty_cycle_percent) {
+bool PwmClass::play_sequence(PinName pin, const uint16_t* compare_values, uint32_t num_values, bool loop)
+{
+  if (pin >= PIN_NAME_MAX || compare_values == nullptr || num_values == 0u
+      || num_values > (uint32_t)DMADRV_MAX_XFER_COUNT) {
+    return false;
+  }
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+
+  uint8_t pwm_channel_idx = this->get_duty_cycle_mode_channel_idx(pin);
+  if (pwm_channel_idx == UINT8_MAX) {
     xSemaphoreGive(this->pwm_mutex);
-    return;
+    return false;
   }
-  this->pwm_pins[pwm_channel_idx].duty_cycle_percent = (uint8_t)duty_cycle_percent;
+  pwm_pin_t* pwm_pin = &this->pwm_pins[pwm_channel_idx];
+  this->stop_sequence_channel(pwm_pin);
 
-  // Stop the PWM on 0 duty cycle (if auto deinit is enabled), set the requested duty cycle otherwise
-  if (duty_cycle_percent == 0 && this->auto_deinit) {
-    this->stop(pin);
+  // The LDMA writes the compare values in 16 bits
+  DMADRV_PeripheralSignal_t dma_signal;
+  if (TIMER_TopGet(pwm_pin->inst.timer) >= UINT16_MAX || !get_timer_dma_signal(pwm_pin->inst.timer, dma_signal)) {
+    xSemaphoreGive(this->pwm_mutex);
+    return false;
+  }
+
+  // Allocate a DMA channel for moving the compare values to the TIMER
+  Ecode_t dma_init_res = DMADRV_Init();
+  if ((dma_init_res != ECODE_OK && dma_init_res != ECODE_EMDRV_DMADRV_ALREADY_INITIALIZED)
+      || DMADRV_AllocateChannel(&pwm_pin->sequence_dma_channel, nullptr) != ECODE_OK) {
+    xSemaphoreGive(this->pwm_mutex);
+    return false;
+  }
+
+  pwm_pin->sequence_looping = loop;
+  pwm_pin->sequence_finished = false;
+  pwm_pin->sequence_running = true;
+  // The duty cycle is unknown after the sequence - the next duty cycle write always takes effect
+  pwm_pin->duty_cycle = -1;
+
+  // Each overflow of the TIMER moves the next value to the buffered compare register - it's latched at the next period
+  void* ocb = (void*)&pwm_pin->inst.timer->CC[pwm_pin->inst.channel].OCB;
+  uint16_t* values = const_cast<uint16_t*>(compare_values);
+  if (loop) {
+    DMADRV_MemoryPeripheralPingPong(pwm_pin->sequence_dma_channel, dma_signal, ocb,
+                                    values, values, true, (int)num_values,
+                                    dmadrvDataSize2, &PwmClass::sequence_dma_callback, pwm_pin);
   } else {
-    sl_pwm_set_duty_cycle(&this->pwm_pins[pwm_channel_idx].inst, (uint8_t)duty_cycle_percent);
-    this->duty_cycle_set_time = millis();
+    DMADRV_MemoryPeripheral(pwm_pin->sequence_dma_channel, dma_signal, ocb,
+                            values, true, (int)num_values,
+                            dmadrvDataSize2, &PwmClass::sequence_dma_callback, pwm_pin);
   }
 
   xSemaphoreGive(this->pwm_mutex);
+  return true;
+}
+
+void PwmClass::stop_sequence(PinName pin)
+{
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  uint8_t pwm_channel_idx = this->get_pwm_channel_idx_for_pin(pin);
+  if (pwm_channel_idx != UINT8_MAX) {
+    this->stop_sequence_channel(&this->pwm_pins[pwm_channel_idx]);
+  }
+  xSemaphoreGive(this->pwm_mutex);
+}
+
+bool PwmClass::is_sequence_playing(PinName pin)
+{
+  uint8_t pwm_channel_idx = this->get_pwm_channel_idx_for_pin(pin);
+  if (pwm_channel_idx == UINT8_MAX) {
+    return false;
+  }
+  return this->pwm_pins[pwm_channel_idx].sequence_running && !this->pwm_pins[pwm_channel_idx].sequence_finished;
+}
+
+bool PwmClass::generate_sequence(PinName pin, pwm_sequence_shape_t shape, uint16_t* buffer, uint32_t num_values, bool gamma_correction)
+{
+  if (pin >= PIN_NAME_MAX || buffer == nullptr || num_values == 0u) {
+    return false;
+  }
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  uint8_t pwm_channel_idx = this->get_duty_cycle_mode_channel_idx(pin);
+  uint32_t top = 0u;
+  if (pwm_channel_idx != UINT8_MAX) {
+    top = TIMER_TopGet(this->pwm_pins[pwm_channel_idx].inst.timer);
+  }
+  xSemaphoreGive(this->pwm_mutex);
+  if (pwm_channel_idx == UINT8_MAX || top >= UINT16_MAX) {
+    return false;
+  }
+
+  // A compare value above TOP keeps the output high for the full duty cycle
+  uint32_t full_scale = top + 1u;
+  for (uint32_t i = 0; i < num_values; i++) {
+    // Brightness level of the shape from 0 to 65535
+    uint32_t level = UINT16_MAX;
+    uint32_t ramp = UINT16_MAX;
+    if (num_values > 1u) {
+      ramp = (uint32_t)((uint64_t)i * UINT16_MAX / (num_values - 1u));
+    }
+    switch (shape) {
+      case PWM_SEQUENCE_FADE_IN:
+        level = ramp;
+        break;
+      case PWM_SEQUENCE_FADE_OUT:
+        level = UINT16_MAX - ramp;
+        break;
+      case PWM_SEQUENCE_BREATHE:
+      {
+        // Rises during the first half of the sequence and falls during the second half
+        uint32_t position = (uint32_t)((uint64_t)i * 2u * UINT16_MAX / num_values);
+        level = (position <= UINT16_MAX) ? position : (2u * UINT16_MAX - position);
+        break;
+      }
+      default:
+        break;
+    }
+    if (level >= UINT16_MAX) {
+      buffer[i] = (uint16_t)full_scale;
+      continue;
+    }
+    if (gamma_correction) {
+      level = apply_gamma(level);
+    }
+    buffer[i] = (uint16_t)((level * full_scale) >> 16);
+  }
+  return true;
+}
+
+void PwmClass::stop_sequence_channel(pwm_pin_t* pwm_pin)
+{
+  if (!pwm_pin->sequence_running) {
+    return;
+  }
+  DMADRV_StopTransfer(pwm_pin->sequence_dma_channel);
+  DMADRV_FreeChannel(pwm_pin->sequence_dma_channel);
+  pwm_pin->sequence_running = false;
+}
+
+bool PwmClass::sequence_dma_callback(unsigned int channel, unsigned int sequence_num, void* user_param)
+{
+  (void)channel;
+  (void)sequence_num;
+  pwm_pin_t* pwm_pin = static_cast<pwm_pin_t*>(user_param);
+  // A one-shot sequence keeps its last value on the output
+  if (!pwm_pin->sequence_looping) {
+    pwm_pin->sequence_finished = true;
+  }
+  return pwm_pin->sequence_looping;
 }
 
 void PwmClass::frequency_mode(PinName pin, int frequency)
@@ -152,7 +467,8 @@ void PwmClass::frequency_mode(PinName pin, int frequency)
     xSemaphoreGive(this->pwm_mutex);
     return;
   }
-  // Initialize PWM with the requested frequency
+  // Initialize PWM with the requested frequency - release the channel of the previous tone first
+  this->stop(pin);
   if (!this->init(pin, frequency)) {
     xSemaphoreGive(this->pwm_mutex);
     return;
@@ -167,15 +483,31 @@ void PwmClass::frequency_mode(PinName pin, int frequency)
 
 void PwmClass::stop(PinName pin)
 {
+  if (pin == this->tone_pin) {
+    this->tone_stop();
+  }
+
   uint8_t pwm_channel_idx = this->get_pwm_channel_idx_for_pin(pin);
   if (pwm_channel_idx == UINT8_MAX) {
     return;
   }
+  this->stop_sequence_channel(&this->pwm_pins[pwm_channel_idx]);
   sl_pwm_stop(&this->pwm_pins[pwm_channel_idx].inst);
 
-  // Deinit the PWM peripheral if there are no users left
-  if (this->get_num_of_pwm_channels_in_use() == 0) {
-    sl_pwm_deinit(&this->pwm_pins[pwm_channel_idx].inst);
+  pwm_timer_t* pwm_timer = &this->pwm_timers[this->pwm_pins[pwm_channel_idx].timer_idx];
+  pwm_timer->channel_mask &= (uint8_t)~(1u << this->pwm_pins[pwm_channel_idx].inst.channel);
+
+  // Deinit the TIMER if there are no users left on it
+  if (pwm_timer->channel_mask == 0u) {
+    if (pwm_timer->timer == TIMER0) {
+      sl_pwm_deinit(&this->pwm_pins[pwm_channel_idx].inst);
+    } else {
+      // Borrowed TIMERs are reset when they're given back to the allocator
+      hw_timer_free(pwm_timer->timer);
+    }
+    pwm_timer->timer = nullptr;
+    pwm_timer->frequency = 0;
+    pwm_timer->exclusive = false;
 
     #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
     // Remove the energy mode requirement
@@ -186,13 +518,241 @@ void PwmClass::stop(PinName pin)
   this->pwm_pins[pwm_channel_idx].pin = PIN_NAME_MAX;
 }
 
+void PwmClass::duty_cycle_mode_set_frequency(PinName pin, int frequency)
+{
+  if (pin >= PIN_NAME_MAX || frequency <= 0) {
+    return;
+  }
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+
+  uint8_t pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
+  if (this->pwm_mode != pwm_mode_t::DUTY_CYCLE || pwm_channel_idx == UINT8_MAX) {
+    xSemaphoreGive(this->pwm_mutex);
+    return;
+  }
+  if (this->pwm_timers[this->pwm_pins[pwm_channel_idx].timer_idx].frequency == frequency) {
+    xSemaphoreGive(this->pwm_mutex);
+    return;
+  }
+
+  // Move the channel to a TIMER running at the new frequency and restore its duty cycle
+  int32_t duty_cycle = this->pwm_pins[pwm_channel_idx].duty_cycle;
+  this->stop(pin);
+  if (this->init(pin, frequency)) {
+    pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
+    if (duty_cycle >= 0) {
+      sl_pwm_instance_t* inst = &this->pwm_pins[pwm_channel_idx].inst;
+      this->pwm_pins[pwm_channel_idx].duty_cycle = duty_cycle;
+      TIMER_CompareBufSet(inst->timer, inst->channel, this->calc_compare_value(inst->timer, (uint32_t)duty_cycle));
+    }
+  }
+
+  xSemaphoreGive(this->pwm_mutex);
+}
+
+bool PwmClass::tone_queue(PinName pin, unsigned int frequency, unsigned long duration)
+{
+  if (pin >= PIN_NAME_MAX || frequency > UINT16_MAX || duration == 0u) {
+    return false;
+  }
+  tone_note_t note = { (uint16_t)frequency, (uint32_t)duration };
+  uint32_t prescaler;
+  uint32_t top;
+
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  // Append the note while the timer is still playing - checked atomically as the last note may end at any time
+  bool queued = false;
+  bool playing = false;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  playing = this->tone_playing;
+  if (playing && pin == this->tone_pin && (note.frequency == 0u || this->tone_calc_period(note.frequency, prescaler, top))) {
+    queued = this->tone_notes.push(note);
+  }
+  CORE_EXIT_ATOMIC();
+
+  if (!playing) {
+    queued = this->tone_start(pin, note);
+  }
+  xSemaphoreGive(this->pwm_mutex);
+  return queued;
+}
+
+bool PwmClass::is_tone_playing()
+{
+  return this->tone_playing;
+}
+
+void PwmClass::task()
+{
+  // Release the channel after the last note - this can't be done from the timer interrupt
+  if (this->tone_pin == PIN_NAME_MAX || this->tone_playing) {
+    return;
+  }
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  if (this->tone_pin != PIN_NAME_MAX && !this->tone_playing) {
+    this->stop(this->tone_pin);
+  }
+  xSemaphoreGive(this->pwm_mutex);
+}
+
+bool PwmClass::tone_start(PinName pin, const tone_note_t& note)
+{
+  // If the PWM was running in a different mode before - deinitialize it
+  if (this->pwm_mode != pwm_mode_t::FREQUENCY) {
+    deinit_all_pwm_channels();
+  }
+  this->pwm_mode = pwm_mode_t::FREQUENCY;
+
+  // Release the channel of the previous tone and start the first note - a rest starts with the output stopped
+  if (this->tone_pin != PIN_NAME_MAX && this->tone_pin != pin) {
+    this->stop(this->tone_pin);
+  }
+  this->stop(pin);
+  // The notes are switched by rewriting the period of the TIMER - it can't be shared with other channels
+  int frequency = (note.frequency != 0u) ? (int)note.frequency : this->duty_cycle_mode_default_freq;
+  if (!this->init(pin, frequency, true)) {
+    return false;
+  }
+  uint8_t pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
+
+  // Keep a copy of the channel for switching the notes from the timer interrupt
+  this->tone_inst = this->pwm_pins[pwm_channel_idx].inst;
+  this->tone_clock_freq = CMU_ClockFreqGet(hw_timer_get_clock(this->tone_inst.timer));
+  uint32_t prescaler;
+  uint32_t top;
+  if (note.frequency != 0u && !this->tone_calc_period(note.frequency, prescaler, top)) {
+    this->stop(pin);
+    return false;
+  }
+  this->tone_apply_note(note);
+  // The channel is released from the Arduino task after the last note
+  register_arduino_task_hook(&pwm_task_hook);
+  this->tone_pin = pin;
+  this->tone_playing = true;
+
+  sl_status_t status = sl_sleeptimer_start_timer_ms(&this->tone_timer,
+                                                    note.duration,
+                                                    &PwmClass::tone_timer_callback,
+                                                    this,
+                                                    0u,
+                                                    0u);
+  if (status != SL_STATUS_OK) {
+    this->tone_playing = false;
+    this->stop(pin);
+    return false;
+  }
+  return true;
+}
+
+void PwmClass::tone_apply_note(const tone_note_t& note)
+{
+  if (note.frequency == 0u) {
+    sl_pwm_stop(&this->tone_inst);
+    return;
+  }
+  uint32_t prescaler;
+  uint32_t top;
+  if (!this->tone_calc_period(note.frequency, prescaler, top)) {
+    sl_pwm_stop(&this->tone_inst);
+    return;
+  }
+  TIMER_TypeDef* timer = this->tone_inst.timer;
+  if (prescaler == timer_get_prescaler(timer)) {
+    // Set the period and the 50% duty cycle of the note in the buffer registers - they're latched at the end of the current period
+    TIMER_TopBufSet(timer, top);
+    TIMER_CompareBufSet(timer, this->tone_inst.channel, (top + 1u) / 2u);
+  } else {
+    // A different prescaler needs the TIMER to be reconfigured - the note starts with a new period right away
+    timer_set_prescaler(timer, prescaler);
+    TIMER_TopSet(timer, top);
+    TIMER_TopBufSet(timer, top);
+    TIMER_CompareSet(timer, this->tone_inst.channel, (top + 1u) / 2u);
+    TIMER_CompareBufSet(timer, this->tone_inst.channel, (top + 1u) / 2u);
+    TIMER_CounterSet(timer, 0u);
+    timer->CMD = TIMER_CMD_START;
+  }
+  sl_pwm_start(&this->tone_inst);
+}
+
+bool PwmClass::tone_calc_period(uint16_t frequency, uint32_t& prescaler, uint32_t& top)
+{
+  if (frequency == 0u) {
+    return false;
+  }
+  // Use the smallest prescaler which fits the period of the note into the counter - the pitch is the most accurate with it
+  uint32_t period_ticks = this->tone_clock_freq / frequency;
+  uint64_t counter_range = (uint64_t)TIMER_MaxCount(this->tone_inst.timer) + 1u;
+  if (period_ticks < 2u) {
+    return false;
+  }
+  prescaler = (uint32_t)((period_ticks - 1u) / counter_range) + 1u;
+  if (prescaler > this->tone_max_prescaler) {
+    // The note is too low for the TIMER
+    return false;
+  }
+  top = this->tone_clock_freq / ((uint32_t)frequency * prescaler) - 1u;
+  return true;
+}
+
+void PwmClass::tone_next_note()
+{
+  tone_note_t note;
+  if (!this->tone_notes.pop(note)) {
+    // The last note is over - silence the output, the channel is released by the Arduino task
+    sl_pwm_stop(&this->tone_inst);
+    this->tone_playing = false;
+    return;
+  }
+  this->tone_apply_note(note);
+  sl_status_t status = sl_sleeptimer_start_timer_ms(&this->tone_timer,
+                                                    note.duration,
+                                                    &PwmClass::tone_timer_callback,
+                                                    this,
+                                                    0u,
+                                                    0u);
+  if (status != SL_STATUS_OK) {
+    sl_pwm_stop(&this->tone_inst);
+    this->tone_playing = false;
+  }
+}
+
+void PwmClass::tone_stop()
+{
+  sl_sleeptimer_stop_timer(&this->tone_timer);
+  // The timer interrupt won't consume notes anymore - the queue can be emptied from here
+  this->tone_notes.clear();
+  this->tone_playing = false;
+  this->tone_pin = PIN_NAME_MAX;
+}
+
+void PwmClass::tone_timer_callback(sl_sleeptimer_timer_handle_t* handle, void* data)
+{
+  (void)handle;
+  static_cast<PwmClass*>(data)->tone_next_note();
+}
+
 void PwmClass::duty_cycle_mode_set_write_resolution(uint8_t resolution)
 {
   if (resolution < 1 || resolution > this->duty_cycle_mode_write_resolution_max) {
     return;
   }
   this->duty_cycle_mode_write_resolution = resolution;
-  this->duty_cycle_mode_max_value = pow(2, this->duty_cycle_mode_write_resolution) - 1;
+  this->duty_cycle_mode_max_value = (1u << resolution) - 1u;
+}
+
+uint32_t PwmClass::calc_compare_value(TIMER_TypeDef* timer, uint32_t duty_cycle)
+{
+  // sl_pwm_init() sets the TOP value from the frequency - the TIMER counts from 0 to TOP in each period
+  uint32_t top = TIMER_TopGet(timer);
+
+  // A compare value above TOP is never matched - the output stays high for the full duty cycle
+  if (duty_cycle >= this->duty_cycle_mode_max_value) {
+    return (top < TIMER_MaxCount(timer)) ? top + 1u : top;
+  }
+
+  // Scale the duty cycle from the write resolution to the TIMER period with a multiply and shift
+  return (uint32_t)(((uint64_t)duty_cycle * (top + 1u)) >> this->duty_cycle_mode_write_resolution);
 }
 
 void PwmClass::set_auto_deinit(bool auto_deinit)
@@ -29,7 +29,6 @@
 #ifndef __ARDUINO_PWM_H
 #define __ARDUINO_PWM_H
 
-#include <cmath>
 #include <inttypes.h>
 #include "pinDefinitions.h"
 #include "wiring_private.h"
@@ -37,11 +36,31 @@
 #include "em_gpio.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "dmadrv.h"
+#include "spsc_queue.h"
+#include "sl_sleeptimer.h"
 
 extern "C" {
   #include "sl_power_manager.h"
 }
 
+// Number of notes that can be queued for background tone playback
+// Must be a power of two
+#ifndef TONE_QUEUE_SIZE
+#define TONE_QUEUE_SIZE 32
+#endif // TONE_QUEUE_SIZE
+
+typedef struct {
+  uint16_t frequency;        // The frequency of the note in hertz - 0 for a rest
+  uint32_t duration;         // The duration of the note in milliseconds
+} tone_note_t;
+
+enum pwm_sequence_shape_t {
+  PWM_SEQUENCE_FADE_IN = 0,
+  PWM_SEQUENCE_FADE_OUT,
+  PWM_SEQUENCE_BREATHE
+};
+
 namespace arduino {
 class PwmClass {
 public:
@@ -54,10 +73,11 @@ public:
    * PWM signal generation in duty cycle mode
    * In this mode the frequency is fixed at a constant value and the duty
    * cycle is variable by the user. Used for 'analogWrite'.
-   * Can handle multiple channels.
+   * Can handle multiple channels - they are spread across the TIMER peripherals,
+   * each TIMER drives up to 3 channels running at the same frequency.
    *
    * @param[in] pin output pin for the PWM signal
-   * @param[in] duty_cycle duty cycle for the PWM signal (0-255)
+   * @param[in] duty_cycle duty cycle for the PWM signal (0-255 with the default write resolution)
    *****************************************************************************/
   void duty_cycle_mode(PinName pin, int duty_cycle);
 
@@ -79,9 +99,23 @@ public:
    *****************************************************************************/
   void stop(PinName pin);
 
+  /***************************************************************************//**
+   * Sets the frequency of a channel running in duty cycle mode
+   * The channel is moved to a TIMER which runs at the requested frequency
+   * (or to a free TIMER) and keeps its duty cycle - the other channels are not
+   * affected. The frequency is kept until the channel is stopped.
+   *
+   * @param[in] pin the output pin of the PWM channel
+   * @param[in] frequency the requested frequency in hertz
+   *****************************************************************************/
+  void duty_cycle_mode_set_frequency(PinName pin, int frequency);
+
   /***************************************************************************//**
    * Sets the write resolution in bits.
-   * The default is 8 bits, the maximum is 12 bits.
+   * The default is 8 bits, the maximum is 16 bits.
+   * The duty cycle is programmed directly into the TIMER compare register, so
+   * the effective resolution is only limited by the number of TIMER ticks in
+   * a PWM period (e.g. about 15 bits at 1 kHz from a 39 MHz clock).
    *
    * @param[in] resolution the requested write resolution in bits
    ******************************************************************************/
@@ -89,9 +123,9 @@ public:
 
   /***************************************************************************//**
    * Turns the automatic deinitialization feature on or off.
-   * When it's on the PWM hardware will be deinitialized when 0 duty cycle is
-   * requested. If multiple channels are active, then this deinitialization will
-   * momentarily interrupt the other channels.
+   * When it's on the PWM channel will be stopped when 0 duty cycle is requested.
+   * The TIMER driving the channel is deinitialized once none of its channels
+   * are in use, so the other channels keep running.
    * When auto deinit is off PWM can still be stopped by calling stop() explicitly.
    * It's on by default. This setting is only relevant in duty cycle mode.
    *
@@ -99,16 +133,130 @@ public:
    ******************************************************************************/
   void set_auto_deinit(bool auto_deinit);
 
+  /***************************************************************************//**
+   * Plays a sequence of TIMER compare values on a PWM channel
+   * The LDMA moves the next value to the channel's buffered compare register
+   * on each TIMER overflow, so one value is played in each PWM period without
+   * CPU involvement. The values are in TIMER ticks, see generate_sequence().
+   * The buffer has to stay valid while the sequence is playing. Writing a duty
+   * cycle or stopping the pin stops the sequence.
+   *
+   * @param[in] pin the output pin of the PWM channel
+   * @param[in] compare_values the compare values to play
+   * @param[in] num_values the number of values - at most 'DMADRV_MAX_XFER_COUNT'
+   * @param[in] loop true to repeat the sequence until stopped, false to play it once
+   *
+   * @return true if the sequence started, false otherwise
+   ******************************************************************************/
+  bool play_sequence(PinName pin, const uint16_t* compare_values, uint32_t num_values, bool loop);
+
+  /***************************************************************************//**
+   * Stops the sequence playing on a PWM channel - the output keeps the last value
+   *
+   * @param[in] pin the output pin of the PWM channel
+   ******************************************************************************/
+  void stop_sequence(PinName pin);
+
+  /***************************************************************************//**
+   * Returns whether a sequence is playing on a PWM channel
+   *
+   * @param[in] pin the output pin of the PWM channel
+   *
+   * @return true if a sequence is playing, false otherwise
+   ******************************************************************************/
+  bool is_sequence_playing(PinName pin);
+
+  /***************************************************************************//**
+   * Fills a buffer with a fade or breathing sequence for play_sequence()
+   * The compare values are calculated from the current TIMER period of the pin,
+   * so the frequency must not be changed afterwards. The sequence lasts
+   * 'num_values' PWM periods.
+   *
+   * @param[in] pin the output pin of the PWM channel - initialized if needed
+   * @param[in] shape the shape of the sequence from 'pwm_sequence_shape_t'
+   * @param[out] buffer the buffer to fill
+   * @param[in] num_values the number of values
+   * @param[in] gamma_correction true to apply a 2.2 gamma curve for a perceptually even LED fade
+   *
+   * @return true if the buffer was filled, false otherwise
+   ******************************************************************************/
+  bool generate_sequence(PinName pin, pwm_sequence_shape_t shape, uint16_t* buffer, uint32_t num_values, bool gamma_correction);
+
+  /***************************************************************************//**
+   * Queues a note to be played in frequency mode for a given duration
+   * The notes are played in the background one after another - a timer switches
+   * to the next note and stops the output after the last one, so the caller
+   * doesn't have to wait. Used for 'tone' with a duration.
+   * Notes can only be queued for the pin which is currently playing.
+   * The TIMER prescaler is set for each note, so frequencies from 65535 Hz down
+   * to about 1 Hz can be played even on the 16 bit TIMERs - notes out of this
+   * range are rejected.
+   *
+   * @param[in] pin output pin for the tone
+   * @param[in] frequency the frequency of the note in hertz (1 - 65535) - 0 for a rest
+   * @param[in] duration the duration of the note in milliseconds
+   *
+   * @return true if the note was queued, false if the queue is full,
+   *         an other pin is playing or the frequency is out of range
+   ******************************************************************************/
+  bool tone_queue(PinName pin, unsigned int frequency, unsigned long duration);
+
+  /***************************************************************************//**
+   * Returns whether queued notes are being played
+   *
+   * @return true if a note is playing, false otherwise
+   ******************************************************************************/
+  bool is_tone_playing();
+
+  /***************************************************************************//**
+   * Releases the PWM channel of finished notes - called by the Arduino task
+   ******************************************************************************/
+  void task();
+
 private:
   /**************************************************************************//**
    * Initializes PWM signal generation
    *
    * @param[in] pin output pin for the PWM signal
    * @param[in] frequency the desired frequency of the PWM signal
+   * @param[in] exclusive if true the channel gets a TIMER which isn't shared with other channels
    *
    * @return true if the initialization was successful, false otherwise
    *****************************************************************************/
-  bool init(PinName pin, int frequency);
+  bool init(PinName pin, int frequency, bool exclusive = false);
+
+  /**************************************************************************//**
+   * Provides a TIMER for a new PWM channel
+   * Prefers a TIMER which already runs at the requested frequency and has
+   * a free CC channel, otherwise starts using a free TIMER.
+   * Exclusive TIMERs are never shared - neither with a new exclusive channel
+   * nor with other channels.
+   *
+   * @param[in] frequency the frequency of the new PWM channel
+   * @param[in] exclusive if true a free TIMER is reserved for the channel
+   *
+   * @return the index in 'pwm_timers' - UINT8_MAX if no TIMER is available
+   *****************************************************************************/
+  uint8_t allocate_pwm_timer(int frequency, bool exclusive);
+
+  /**************************************************************************//**
+   * Calculates the TIMER compare value for a duty cycle
+   *
+   * @param[in] timer the TIMER driving the PWM channel
+   * @param[in] duty_cycle the duty cycle in the current write resolution
+   *
+   * @return the compare value producing the duty cycle
+   *****************************************************************************/
+  uint32_t calc_compare_value(TIMER_TypeDef* timer, uint32_t duty_cycle);
+
+  /**************************************************************************//**
+   * Switches to duty cycle mode and initializes the PWM channel of a pin if needed
+   *
+   * @param[in] pin the output pin of the PWM channel
+   *
+   * @return the index in 'pwm_pins' for the pin - UINT8_MAX if it could not be initialized
+   *****************************************************************************/
+  uint8_t get_duty_cycle_mode_channel_idx(PinName pin);
 
   enum pwm_mode_t {
     DUTY_CYCLE,
@@ -124,19 +272,33 @@ private:
   SemaphoreHandle_t pwm_mutex;
   StaticSemaphore_t pwm_mutex_buf;
 
-  static const uint8_t max_pwm_channels = 3u;
-  static const uint32_t pwm_stabilization_time_ms = 2u;
-
-  uint32_t duty_cycle_set_time;
+  // TIMER0 is reserved for the PWM, TIMER1-4 are borrowed from the TIMER allocator when needed
+  static const uint8_t max_pwm_timers = 5u;
+  static const uint8_t max_pwm_channels_per_timer = 3u;
+  static const uint8_t max_pwm_channels = max_pwm_timers * max_pwm_channels_per_timer;
 
   uint8_t duty_cycle_mode_write_resolution;
   uint32_t duty_cycle_mode_max_value;
-  static const uint8_t duty_cycle_mode_write_resolution_max = 12u;
+  static const uint8_t duty_cycle_mode_write_resolution_max = 16u;
+
+  typedef struct {
+    TIMER_TypeDef* timer;
+    int frequency;
+    uint8_t channel_mask;
+    bool exclusive;
+  } pwm_timer_t;
+
+  pwm_timer_t pwm_timers[max_pwm_timers];
 
   typedef struct {
     PinName pin;
-    uint8_t duty_cycle_percent;
+    uint8_t timer_idx;
+    int32_t duty_cycle;
     sl_pwm_instance_t inst;
+    bool sequence_running;
+    bool sequence_looping;
+    volatile bool sequence_finished;
+    unsigned int sequence_dma_channel;
   } pwm_pin_t;
 
   pwm_pin_t pwm_pins[max_pwm_channels];
@@ -169,6 +331,63 @@ private:
    * Deinitializes all active PWM channels
    *****************************************************************************/
   void deinit_all_pwm_channels();
+
+  /**************************************************************************//**
+   * Stops the sequence playing on a PWM channel and frees its DMA channel
+   *
+   * @param[in] pwm_pin the PWM channel
+   *****************************************************************************/
+  void stop_sequence_channel(pwm_pin_t* pwm_pin);
+
+  static bool sequence_dma_callback(unsigned int channel, unsigned int sequence_num, void* user_param);
+
+  /**************************************************************************//**
+   * Starts playing a note on a pin in frequency mode
+   *
+   * @param[in] pin output pin for the tone
+   * @param[in] note the note to play
+   *
+   * @return true if the note started, false otherwise
+   *****************************************************************************/
+  bool tone_start(PinName pin, const tone_note_t& note);
+
+  /**************************************************************************//**
+   * Switches the tone output to a note at register level - safe to call from interrupts
+   *
+   * @param[in] note the note to switch to
+   *****************************************************************************/
+  void tone_apply_note(const tone_note_t& note);
+
+  /**************************************************************************//**
+   * Calculates the TIMER prescaler and period for a note on the tone TIMER
+   *
+   * @param[in] frequency the frequency of the note in hertz
+   * @param[out] prescaler the clock divider for the TIMER
+   * @param[out] top the TOP value of the TIMER
+   *
+   * @return true if the TIMER can play the note, false otherwise
+   *****************************************************************************/
+  bool tone_calc_period(uint16_t frequency, uint32_t& prescaler, uint32_t& top);
+
+  /**************************************************************************//**
+   * Plays the next queued note or stops the output - called from the tone timer's interrupt
+   *****************************************************************************/
+  void tone_next_note();
+
+  /**************************************************************************//**
+   * Stops the tone timer and drops the queued notes
+   *****************************************************************************/
+  void tone_stop();
+
+  static void tone_timer_callback(sl_sleeptimer_timer_handle_t* handle, void* data);
+
+  SpscQueue<tone_note_t, TONE_QUEUE_SIZE> tone_notes;
+  sl_sleeptimer_timer_handle_t tone_timer;
+  PinName tone_pin;
+  volatile bool tone_playing;
+  sl_pwm_instance_t tone_inst;
+  uint32_t tone_clock_freq;
+  static const uint32_t tone_max_prescaler = 1024u;
 };
 } // namespace arduino
 
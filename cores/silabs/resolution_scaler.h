@@ -0,0 +1,113 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef __ARDUINO_RESOLUTION_SCALER_H
+#define __ARDUINO_RESOLUTION_SCALER_H
+
+#include <inttypes.h>
+
+namespace arduino {
+/***************************************************************************//**
+ * Integer scaling of values from 0-'input_max' to 0-'output_max'
+ * Gives the same results as map(value, 0, input_max, 0, output_max), but the
+ * scale factor is calculated only when the input range changes - scaling a value
+ * takes a single multiply and shift without any division or floating point math.
+ * The results are exact as long as the bit widths of 'input_max' and 'output_max'
+ * add up to at most 30 bits.
+ ******************************************************************************/
+class ResolutionScaler {
+public:
+  ResolutionScaler(uint32_t input_max, uint32_t output_max) :
+    input_max(input_max),
+    output_max(output_max),
+    factor(0u),
+    shift(0u)
+  {
+    this->calc_factor();
+  }
+
+  /***************************************************************************//**
+   * Sets the input range from a resolution in bits
+   *
+   * @param[in] resolution the resolution of the input values in bits (1-16)
+   ******************************************************************************/
+  void set_input_resolution(uint8_t resolution)
+  {
+    if (resolution < 1u || resolution > 16u) {
+      return;
+    }
+    this->input_max = (1u << resolution) - 1u;
+    this->calc_factor();
+  }
+
+  /***************************************************************************//**
+   * Returns the largest accepted input value
+   *
+   * @return the largest accepted input value
+   ******************************************************************************/
+  uint32_t get_input_max() const
+  {
+    return this->input_max;
+  }
+
+  /***************************************************************************//**
+   * Scales a value from the input range to the output range
+   *
+   * @param[in] value the value to scale - at most get_input_max()
+   *
+   * @return the scaled value rounded down
+   ******************************************************************************/
+  uint32_t scale(uint32_t value) const
+  {
+    return (uint32_t)(((uint64_t)value * this->factor) >> this->shift);
+  }
+
+private:
+  void calc_factor()
+  {
+    if (this->input_max == 0u || this->output_max == 0u) {
+      this->factor = 0u;
+      this->shift = 0u;
+      return;
+    }
+    // Use the largest shift which still keeps the factor in 32 bits - this is
+    // precise enough for the rounding down of a value*factor product to be exact
+    uint8_t output_bits = 32u - __builtin_clz(this->output_max);
+    uint8_t input_log2 = 31u - __builtin_clz(this->input_max);
+    this->shift = 32u - output_bits + input_log2;
+    uint64_t numerator = (uint64_t)this->output_max << this->shift;
+    this->factor = (uint32_t)((numerator + this->input_max - 1u) / this->input_max);
+  }
+
+  uint32_t input_max;
+  uint32_t output_max;
+  uint32_t factor;
+  uint8_t shift;
+};
+} // namespace arduino
+
+#endif // __ARDUINO_RESOLUTION_SCALER_H
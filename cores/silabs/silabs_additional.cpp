@@ -66,7 +66,7 @@ String getCoreVersion()
   return String(ARDUINO_SILABS);
 }
 
-void setCPUClock(cpu_clock_t clock)
+static void set_cpu_clock_source(cpu_clock_t clock)
 {
   CMU_DPLLInit_TypeDef pll_init;
   switch (clock) {
@@ -90,6 +90,13 @@ void setCPUClock(cpu_clock_t clock)
   CMU_ClockSelectSet(cmuClock_SYSCLK, cmuSelect_HFRCODPLL);
 }
 
+void setCPUClock(cpu_clock_t clock)
+{
+  set_cpu_clock_source(clock);
+  // The high resolution clock counts CPU cycles - update it with the new frequency
+  sync_hires_clock();
+}
+
 uint32_t getCPUClock()
 {
   return SystemCoreClockGet();
@@ -87,6 +87,44 @@ void setCPUClock(cpu_clock_t clock);
  ******************************************************************************/
 uint32_t getCPUClock();
 
+/***************************************************************************//**
+ * Returns the number of microseconds since the device started as a 64 bit value
+ * Has sub-microsecond resolution and doesn't wrap around.
+ * Has the same accuracy limits after sleep as nanos64().
+ *
+ * @return the number of microseconds since the device started
+ ******************************************************************************/
+uint64_t micros64();
+
+/***************************************************************************//**
+ * Returns the number of nanoseconds since the device started
+ * The time is interpolated between the sleeptimer ticks with the CPU cycle counter,
+ * so its resolution is one CPU clock cycle while the CPU is running.
+ * After the CPU slept the resolution is one sleeptimer tick (30.52 us) until the
+ * next time the clock is read. The returned value never decreases.
+ * While the CPU is awake the cycle counter's rate is steered towards the
+ * sleeptimer, so the clock follows millis() without steps and the differences
+ * between two readings keep their sub-microsecond resolution.
+ * Known limitation: the cycle counter doesn't count in EM1/EM2 sleep, so after
+ * waking up the clock continues from the sleeptimer's time. The first reading
+ * after a wakeup can be up to half a sleeptimer tick (15.26 us) off, and when the
+ * time interpolated before the sleep was ahead of the sleeptimer, the returned
+ * value holds still instead of going backwards. Sleeps shorter than the drift
+ * allowance of the interpolation are corrected gradually instead.
+ *
+ * @return the number of nanoseconds since the device started
+ ******************************************************************************/
+uint64_t nanos64();
+
+/***************************************************************************//**
+ * Returns the current value of the CPU cycle counter
+ * The counter increments on every CPU clock cycle, wraps around at 32 bits
+ * and doesn't count while the CPU sleeps.
+ *
+ * @return the current value of the CPU cycle counter
+ ******************************************************************************/
+uint32_t getCPUCycleCount();
+
 void I2C_Deinit(I2C_TypeDef* i2c_peripheral);
 
 #endif // SILABS_ADDITIONAL_H
\ No newline at end of file
@@ -0,0 +1,119 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __ARDUINO_SPSC_QUEUE_H
+#define __ARDUINO_SPSC_QUEUE_H
+
+#include <stddef.h>
+#include <inttypes.h>
+#include "em_device.h"
+
+namespace arduino {
+/***************************************************************************//**
+ * Lock-free single producer, single consumer queue
+ * One context (e.g. an interrupt handler) may push while another context
+ * (e.g. a task) pops at the same time without disabling interrupts.
+ * The producer only writes 'head' and the consumer only writes 'tail'.
+ * The capacity must be a power of two.
+ ******************************************************************************/
+template<typename T, size_t capacity>
+class SpscQueue {
+  static_assert(capacity > 0u && (capacity & (capacity - 1u)) == 0u, "Capacity must be a power of two");
+
+public:
+  SpscQueue() :
+    head(0u),
+    tail(0u)
+  {
+    ;
+  }
+
+  /***************************************************************************//**
+   * Adds an item to the queue - must only be called from the producer context
+   *
+   * @param[in] item the item to add
+   *
+   * @return true if the item was added, false if the queue was full
+   ******************************************************************************/
+  bool push(const T& item)
+  {
+    uint32_t current_head = this->head;
+    if (current_head - this->tail >= capacity) {
+      return false;
+    }
+    this->buffer[current_head & (capacity - 1u)] = item;
+    // Make sure the item is stored before it's published to the consumer
+    __DMB();
+    this->head = current_head + 1u;
+    return true;
+  }
+
+  /***************************************************************************//**
+   * Removes the oldest item from the queue - must only be called from the consumer context
+   *
+   * @param[out] item the removed item
+   *
+   * @return true if an item was removed, false if the queue was empty
+   ******************************************************************************/
+  bool pop(T& item)
+  {
+    uint32_t current_tail = this->tail;
+    if (current_tail == this->head) {
+      return false;
+    }
+    item = this->buffer[current_tail & (capacity - 1u)];
+    // Make sure the item is read before its slot is released to the producer
+    __DMB();
+    this->tail = current_tail + 1u;
+    return true;
+  }
+
+  /***************************************************************************//**
+   * Returns the number of items in the queue
+   *
+   * @return the number of items in the queue
+   ******************************************************************************/
+  size_t available() const
+  {
+    return this->head - this->tail;
+  }
+
+  /***************************************************************************//**
+   * Removes all items from the queue - must only be called from the consumer context
+   ******************************************************************************/
+  void clear()
+  {
+    this->tail = this->head;
+  }
+
+private:
+  T buffer[capacity];
+  volatile uint32_t head;
+  volatile uint32_t tail;
+};
+} // namespace arduino
+
+#endif // __ARDUINO_SPSC_QUEUE_H
@@ -27,9 +27,172 @@
 #include "pinDefinitions.h"
 #include "pins_arduino.h"
 
-// The sleeptimer is running on a 32.768 kHz oscillator with a tick resolution of 30.52 us
-static const double sleeptimer_tick_period_us = 30.52f;
-static const uint64_t sleeptimer_tick_period_us_x100 = 3052;
+#include "em_core.h"
+
+// The high resolution clock interpolates between sleeptimer ticks with the DWT cycle counter.
+// The cycle counter stops while the CPU sleeps, so the interpolated time is only trusted when it's
+// within one sleeptimer tick (plus a clock drift allowance) of the sleeptimer's time - otherwise the
+// sleeptimer's time is used.
+// While the CPU is awake the clock is steered towards the sleeptimer by adjusting the cycle counter's rate,
+// so the drift between the CPU clock and the sleeptimer clock is corrected without steps in the time.
+static const uint32_t hires_clock_fraction_bits = 28u;
+// Maximum cycle counter difference to interpolate - keeps the fixed point multiplication within 64 bits
+static const uint32_t hires_clock_max_cycle_delta = 1u << 28;
+// Maximum sleeptimer tick difference to convert with a multiplication - keeps it within 64 bits
+static const uint64_t hires_clock_max_tick_delta = 1u << 22;
+// The clock is re-anchored after this many sleeptimer ticks - well before the cycle counter difference gets too large
+static const uint64_t hires_clock_anchor_interval_ticks = 8192u;
+// The clock jumps to the sleeptimer's time instead of being steered when it's off by more than this many ticks
+static const int64_t hires_clock_max_steer_error_ticks = 4;
+// The cycle counter may differ from the sleeptimer by one tick plus 1/4096 (about 240 ppm) of the elapsed time
+static const uint32_t hires_clock_drift_allowance_shift = 12u;
+// The learned rate correction is limited to 1/256 (about 3900 ppm) of the nominal rate
+static const uint32_t hires_clock_max_rate_correction_shift = 8u;
+
+static uint64_t hires_clock_anchor_ns = 0u;
+static uint64_t hires_clock_anchor_ticks = 0u;
+static uint32_t hires_clock_anchor_cycles = 0u;
+static uint64_t hires_clock_last_ns = 0u;
+static uint64_t hires_clock_ns_per_cycle = 0u;          // Fixed point with 'hires_clock_fraction_bits' fraction bits
+static uint64_t hires_clock_ns_per_cycle_nominal = 0u;  // Same fixed point, from the CPU clock frequency
+static int64_t hires_clock_rate_correction = 0;         // Same fixed point, learned offset of the CPU clock to the sleeptimer
+static uint64_t hires_clock_ns_per_tick = 0u;           // Fixed point with 16 fraction bits
+static uint64_t hires_clock_ns_per_tick_x1 = 0u;
+static uint32_t hires_clock_tick_frequency = 32768u;
+static uint32_t hires_clock_cpu_clock = 1000000u;
+static bool hires_clock_initialized = false;
+
+static uint64_t hires_clock_ticks_to_ns(uint64_t ticks)
+{
+  if (ticks < hires_clock_max_tick_delta) {
+    return (ticks * hires_clock_ns_per_tick) >> 16;
+  }
+  // Split into whole seconds and the remainder so that the multiplication can't overflow
+  uint64_t seconds = ticks / hires_clock_tick_frequency;
+  uint64_t remainder = ticks % hires_clock_tick_frequency;
+  return seconds * 1000000000u + remainder * 1000000000u / hires_clock_tick_frequency;
+}
+
+// Returns the sleeptimer's time at the middle of the current tick - the best estimate of the time without the cycle counter
+static uint64_t hires_clock_sleeptimer_ns(uint64_t ticks)
+{
+  return hires_clock_ticks_to_ns(ticks) + (hires_clock_ns_per_tick >> 17);
+}
+
+// Adjusts the cycle counter's rate for the next anchor interval from the difference to the sleeptimer
+// Returns false if the clock is too far off to be steered
+static bool hires_clock_steer(uint64_t now_ns, uint64_t ticks, uint32_t cycle_delta)
+{
+  int64_t error_ns = static_cast<int64_t>(hires_clock_sleeptimer_ns(ticks) - now_ns);
+  int64_t max_error_ns = hires_clock_max_steer_error_ticks * static_cast<int64_t>(hires_clock_ns_per_tick_x1);
+  if (cycle_delta == 0u || error_ns > max_error_ns || error_ns < -max_error_ns) {
+    return false;
+  }
+  // The error over the last interval as a rate - the sleeptimer's tick phase makes it noisy, so it's only applied partially
+  int64_t error_rate = (error_ns * (static_cast<int64_t>(1) << hires_clock_fraction_bits)) / static_cast<int64_t>(cycle_delta);
+  int64_t max_rate_correction = static_cast<int64_t>(hires_clock_ns_per_cycle_nominal >> hires_clock_max_rate_correction_shift);
+  hires_clock_rate_correction += error_rate / 16;
+  if (hires_clock_rate_correction > max_rate_correction) {
+    hires_clock_rate_correction = max_rate_correction;
+  } else if (hires_clock_rate_correction < -max_rate_correction) {
+    hires_clock_rate_correction = -max_rate_correction;
+  }
+  // Remove a quarter of the remaining error during the next interval on top of the learned rate
+  hires_clock_ns_per_cycle = static_cast<uint64_t>(static_cast<int64_t>(hires_clock_ns_per_cycle_nominal) + hires_clock_rate_correction + error_rate / 4);
+  return true;
+}
+
+// Returns the current time in nanoseconds - must be called with interrupts disabled
+// With 'force_anchor' the clock is re-anchored at the returned time
+static uint64_t hires_clock_get_ns(bool force_anchor)
+{
+  uint64_t ticks = sl_sleeptimer_get_tick_count64();
+  uint32_t cycles = DWT->CYCCNT;
+
+  uint64_t tick_delta = ticks - hires_clock_anchor_ticks;
+  uint32_t cycle_delta = cycles - hires_clock_anchor_cycles;
+  uint64_t coarse_ns = hires_clock_ticks_to_ns(tick_delta);
+
+  uint64_t now_ns = 0u;
+  bool fine_valid = false;
+  if (cycle_delta < hires_clock_max_cycle_delta) {
+    uint64_t fine_ns = (static_cast<uint64_t>(cycle_delta) * hires_clock_ns_per_cycle) >> hires_clock_fraction_bits;
+    // Use the cycle counter only if it agrees with the sleeptimer - it doesn't count while the CPU sleeps
+    uint64_t tolerance_ns = hires_clock_ns_per_tick_x1 + (coarse_ns >> hires_clock_drift_allowance_shift);
+    if (fine_ns + tolerance_ns >= coarse_ns && fine_ns <= coarse_ns + tolerance_ns) {
+      now_ns = hires_clock_anchor_ns + fine_ns;
+      fine_valid = true;
+    }
+  }
+  if (!fine_valid) {
+    now_ns = hires_clock_sleeptimer_ns(ticks);
+  }
+
+  // Never go backwards - the sleeptimer based time can be behind the interpolated time
+  if (now_ns < hires_clock_last_ns) {
+    now_ns = hires_clock_last_ns;
+  }
+  hires_clock_last_ns = now_ns;
+
+  // Move the anchor forward periodically - the anchor stays on the interpolated time, so the time is continuous
+  // The clock only jumps to the sleeptimer's time when the cycle counter couldn't be used or the clock is too far off
+  bool steered = fine_valid && tick_delta >= hires_clock_anchor_interval_ticks
+                 && hires_clock_steer(now_ns, ticks, cycle_delta);
+  if (!fine_valid || (tick_delta >= hires_clock_anchor_interval_ticks && !steered)) {
+    hires_clock_anchor_ns = hires_clock_sleeptimer_ns(ticks);
+    hires_clock_anchor_ticks = ticks;
+    hires_clock_anchor_cycles = cycles;
+    hires_clock_ns_per_cycle = static_cast<uint64_t>(static_cast<int64_t>(hires_clock_ns_per_cycle_nominal) + hires_clock_rate_correction);
+  } else if (steered || force_anchor) {
+    hires_clock_anchor_ns = now_ns;
+    hires_clock_anchor_ticks = ticks;
+    hires_clock_anchor_cycles = cycles;
+  }
+  return now_ns;
+}
+
+void init_hires_clock()
+{
+  // Enable the DWT cycle counter - it's not reset, a debugger or profiler may already be using it
+  // The clock is anchored to the current counter value below
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  hires_clock_tick_frequency = sl_sleeptimer_get_timer_frequency();
+  if (hires_clock_tick_frequency == 0u) {
+    hires_clock_tick_frequency = 32768u;
+  }
+  hires_clock_ns_per_tick = (1000000000ull << 16) / hires_clock_tick_frequency;
+  hires_clock_ns_per_tick_x1 = (hires_clock_ns_per_tick >> 16) + 1u;
+  hires_clock_anchor_ticks = sl_sleeptimer_get_tick_count64();
+  hires_clock_anchor_cycles = DWT->CYCCNT;
+  hires_clock_anchor_ns = hires_clock_sleeptimer_ns(hires_clock_anchor_ticks);
+  hires_clock_last_ns = hires_clock_anchor_ns;
+  CORE_EXIT_ATOMIC();
+
+  sync_hires_clock();
+  hires_clock_initialized = true;
+}
+
+void sync_hires_clock()
+{
+  uint32_t cpu_clock = SystemCoreClockGet();
+  if (cpu_clock == 0u) {
+    return;
+  }
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  // Re-anchor at the current time with the cycles since the last anchor counted at the previous frequency
+  // The time stays continuous - the learned rate correction belongs to the previous clock and is dropped
+  (void)hires_clock_get_ns(true);
+  hires_clock_ns_per_cycle_nominal = (1000000000ull << hires_clock_fraction_bits) / cpu_clock;
+  hires_clock_ns_per_cycle = hires_clock_ns_per_cycle_nominal;
+  hires_clock_rate_correction = 0;
+  hires_clock_cpu_clock = cpu_clock;
+  CORE_EXIT_ATOMIC();
+}
 
 uint32_t millis()
 {
@@ -38,10 +201,33 @@ uint32_t millis()
   return static_cast<uint32_t>(millis);
 }
 
+uint64_t nanos64()
+{
+  if (!hires_clock_initialized) {
+    uint64_t nanos = 0u;
+    (void)sl_sleeptimer_tick64_to_ms(sl_sleeptimer_get_tick_count64(), &nanos);
+    return nanos * 1000000u;
+  }
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  uint64_t nanos = hires_clock_get_ns(false);
+  CORE_EXIT_ATOMIC();
+  return nanos;
+}
+
+uint64_t micros64()
+{
+  return nanos64() / 1000u;
+}
+
 uint32_t micros()
 {
-  uint64_t micros = static_cast<uint64_t>(sl_sleeptimer_get_tick_count()) * sleeptimer_tick_period_us_x100 / 100u;
-  return static_cast<uint32_t>(micros);
+  return static_cast<uint32_t>(micros64());
+}
+
+uint32_t getCPUCycleCount()
+{
+  return DWT->CYCCNT;
 }
 
 void delay(uint32_t ms)
@@ -56,7 +242,22 @@ void delay(uint32_t ms)
 
 void delayMicroseconds(unsigned int us)
 {
-  sl_udelay_wait(us);
+  if (!hires_clock_initialized) {
+    sl_udelay_wait(us);
+    return;
+  }
+  // Busy wait on the cycle counter in chunks, so that the cycle count can't overflow
+  const unsigned int max_chunk_us = 1000000u;
+  while (us > 0u) {
+    unsigned int chunk_us = (us > max_chunk_us) ? max_chunk_us : us;
+    // Computed from the full CPU frequency - whole cycles per microsecond would be 1% short at 76.8 MHz
+    uint32_t wait_cycles = static_cast<uint32_t>(static_cast<uint64_t>(chunk_us) * hires_clock_cpu_clock / 1000000u);
+    uint32_t start_cycles = DWT->CYCCNT;
+    while (DWT->CYCCNT - start_cycles < wait_cycles) {
+      ;
+    }
+    us -= chunk_us;
+  }
 }
 
 void yield()
@@ -42,11 +42,64 @@ int analogRead(PinName pin)
   return (int) ADC.get_sample(pin);
 }
 
+bool analogReadMulti(const pin_size_t* pins, uint8_t num_pins, uint16_t* results)
+{
+  if (pins == nullptr || num_pins > AdcClass::max_scan_pins) {
+    return false;
+  }
+  PinName pin_names[AdcClass::max_scan_pins];
+  for (uint8_t i = 0; i < num_pins; i++) {
+    pin_names[i] = pinToPinName(pins[i]);
+    if (pin_names[i] == PIN_NAME_NC) {
+      return false;
+    }
+  }
+  return analogReadMulti(pin_names, num_pins, results);
+}
+
+bool analogReadMulti(const PinName* pins, uint8_t num_pins, uint16_t* results)
+{
+  return ADC.get_scan_samples(pins, num_pins, results);
+}
+
+bool analogReadAsync(pin_size_t pin, adc_read_callback_t callback)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return false;
+  }
+  return analogReadAsync(pin_name, callback);
+}
+
+bool analogReadAsync(PinName pin, adc_read_callback_t callback)
+{
+  return ADC.start_sample_async(pin, callback);
+}
+
+bool analogReadAsyncReady()
+{
+  return ADC.is_async_sample_ready();
+}
+
+int analogReadAsyncResult()
+{
+  return (int) ADC.get_async_sample();
+}
+
 void analogReference(uint8_t reference)
 {
   ADC.set_reference(reference);
 }
 
+void analogReadResolution(int resolution)
+{
+  // Reject out of range values before they're truncated to 8 bits
+  if (resolution < 1 || resolution > (int)ADC.adc_max_read_resolution) {
+    return;
+  }
+  ADC.set_read_resolution((uint8_t)resolution);
+}
+
 void analogReferenceDAC(uint8_t reference)
 {
   #if (NUM_DAC_HW > 0)
@@ -31,4 +31,10 @@ extern "C" {
   #include "em_gpio.h"
 }
 
+// Starts the high resolution clock used by micros() and delayMicroseconds()
+void init_hires_clock();
+
+// Resynchronizes the high resolution clock after the CPU clock frequency changed
+void sync_hires_clock();
+
 #endif // WIRING_PRIVATE_H
@@ -25,6 +25,11 @@
  */
 
 #include "Arduino.h"
+#include "input_capture.h"
+
+// pulseIn() keeps the TIMER of its input capture between the calls, so its
+// accuracy doesn't depend on how many TIMERs were taken by the PWM since the first call
+static arduino::InputCapture pulse_capture;
 
 inline static bool wait_for_pin_state(PinName pin_name, bool state, unsigned long timeout)
 {
@@ -51,6 +56,25 @@ unsigned long pulseIn(PinName pin_name, uint8_t state, unsigned long timeout)
   if (pin_name >= PIN_NAME_MAX || state > HIGH) {
     return 0;
   }
+
+  // Measure the pulse with hardware input capture if a timer is available
+  // The TIMER is only stopped after the measurement - it stays allocated for the next call
+  if (pulse_capture.begin(pin_name)) {
+    unsigned long wait_start = micros();
+    uint32_t pulse_ticks;
+    while (!pulse_capture.read_pulse_ticks(state ? HIGH : LOW, pulse_ticks)) {
+      if (micros() - wait_start > timeout) {
+        pulse_capture.suspend();
+        return 0;
+      }
+      yield();
+    }
+    pulse_capture.suspend();
+    return pulse_capture.ticks_to_us(pulse_ticks);
+  }
+
+  // Fall back to polling the pin if there was no free TIMER at the first call
+  // The result is then measured with micros() and depends on the CPU load
   unsigned long timing_start;
   unsigned long timing_result;
   unsigned long timeout_end = micros() + timeout;
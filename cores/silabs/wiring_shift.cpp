@@ -25,6 +25,78 @@
  */
 #include "Arduino.h"
 
+// The shift functions resolve the pins to their GPIO registers once and
+// then shift the bits with single register writes in an unrolled loop
+
+// Minimum clock high time, clock low time and data setup time in nanoseconds
+// Single register writes are only a few ns apart - shift registers like the
+// 74HC595 / 74HC165 need up to 100 ns at low supply voltages
+#ifndef SHIFT_CLOCK_DELAY_NS
+#define SHIFT_CLOCK_DELAY_NS 100u
+#endif // SHIFT_CLOCK_DELAY_NS
+
+static inline uint32_t get_shift_delay_cycles()
+{
+  return (uint32_t)(((uint64_t)SystemCoreClock * SHIFT_CLOCK_DELAY_NS + 999999999u) / 1000000000u);
+}
+
+static inline void shift_delay(uint32_t delay_cycles)
+{
+  uint32_t start_cycles = DWT->CYCCNT;
+  while (DWT->CYCCNT - start_cycles < delay_cycles) {
+  }
+}
+
+template<uint8_t bit_mask>
+static inline void shift_out_bit(FastPin& data, FastPin& clock, uint8_t val, uint32_t delay_cycles)
+{
+  if (val & bit_mask) {
+    data.set();
+  } else {
+    data.clear();
+  }
+  // Data setup time - also keeps the clock low for long enough
+  shift_delay(delay_cycles);
+  clock.set();
+  shift_delay(delay_cycles);
+  clock.clear();
+}
+
+static void shift_out_byte(FastPin& data, FastPin& clock, BitOrder bitOrder, uint8_t val, uint32_t delay_cycles)
+{
+  if (bitOrder == LSBFIRST) {
+    shift_out_bit<0x01>(data, clock, val, delay_cycles);
+    shift_out_bit<0x02>(data, clock, val, delay_cycles);
+    shift_out_bit<0x04>(data, clock, val, delay_cycles);
+    shift_out_bit<0x08>(data, clock, val, delay_cycles);
+    shift_out_bit<0x10>(data, clock, val, delay_cycles);
+    shift_out_bit<0x20>(data, clock, val, delay_cycles);
+    shift_out_bit<0x40>(data, clock, val, delay_cycles);
+    shift_out_bit<0x80>(data, clock, val, delay_cycles);
+  } else {
+    shift_out_bit<0x80>(data, clock, val, delay_cycles);
+    shift_out_bit<0x40>(data, clock, val, delay_cycles);
+    shift_out_bit<0x20>(data, clock, val, delay_cycles);
+    shift_out_bit<0x10>(data, clock, val, delay_cycles);
+    shift_out_bit<0x08>(data, clock, val, delay_cycles);
+    shift_out_bit<0x04>(data, clock, val, delay_cycles);
+    shift_out_bit<0x02>(data, clock, val, delay_cycles);
+    shift_out_bit<0x01>(data, clock, val, delay_cycles);
+  }
+}
+
+template<uint8_t bit_mask>
+static inline uint8_t shift_in_bit(FastPin& data, FastPin& clock, uint32_t delay_cycles)
+{
+  clock.set();
+  // Sample after the output of the device and the input synchronizer settled
+  shift_delay(delay_cycles);
+  uint8_t bit = data.read() ? bit_mask : 0u;
+  clock.clear();
+  shift_delay(delay_cycles);
+  return bit;
+}
+
 uint8_t shiftIn(pin_size_t dataPin, pin_size_t clockPin, BitOrder bitOrder)
 {
   PinName pin_name_data = pinToPinName(dataPin);
@@ -37,45 +109,65 @@ uint8_t shiftIn(pin_size_t dataPin, pin_size_t clockPin, BitOrder bitOrder)
 
 uint8_t shiftIn(PinName dataPin, PinName clockPin, BitOrder bitOrder)
 {
-  uint8_t value = 0;
-  uint8_t i;
+  FastPin data(dataPin);
+  FastPin clock(clockPin);
+  if (!data.is_valid() || !clock.is_valid()) {
+    return 0;
+  }
 
-  for (i = 0; i < 8; ++i) {
-    digitalWrite(clockPin, HIGH);
-    if (bitOrder == LSBFIRST) {
-      value |= digitalRead(dataPin) << i;
-    } else {
-      value |= digitalRead(dataPin) << (7 - i);
-    }
-    digitalWrite(clockPin, LOW);
+  uint32_t delay_cycles = get_shift_delay_cycles();
+  uint8_t value = 0;
+  if (bitOrder == LSBFIRST) {
+    value |= shift_in_bit<0x01>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x02>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x04>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x08>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x10>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x20>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x40>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x80>(data, clock, delay_cycles);
+  } else {
+    value |= shift_in_bit<0x80>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x40>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x20>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x10>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x08>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x04>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x02>(data, clock, delay_cycles);
+    value |= shift_in_bit<0x01>(data, clock, delay_cycles);
   }
   return value;
 }
 
 void shiftOut(pin_size_t dataPin, pin_size_t clockPin, BitOrder bitOrder, uint8_t val)
+{
+  shiftOut(dataPin, clockPin, bitOrder, &val, 1);
+}
+
+void shiftOut(PinName dataPin, PinName clockPin, BitOrder bitOrder, uint8_t val)
+{
+  shiftOut(dataPin, clockPin, bitOrder, &val, 1);
+}
+
+void shiftOut(pin_size_t dataPin, pin_size_t clockPin, BitOrder bitOrder, const uint8_t* buf, size_t len)
 {
   PinName pin_name_data = pinToPinName(dataPin);
   PinName pin_name_clock = pinToPinName(clockPin);
   if (pin_name_data == PIN_NAME_NC || pin_name_clock == PIN_NAME_NC) {
     return;
   }
-  shiftOut(pin_name_data, pin_name_clock, bitOrder, val);
+  shiftOut(pin_name_data, pin_name_clock, bitOrder, buf, len);
 }
 
-void shiftOut(PinName dataPin, PinName clockPin, BitOrder bitOrder, uint8_t val)
+void shiftOut(PinName dataPin, PinName clockPin, BitOrder bitOrder, const uint8_t* buf, size_t len)
 {
-  uint8_t i;
-
-  for (i = 0; i < 8; i++) {
-    if (bitOrder == LSBFIRST) {
-      digitalWrite(dataPin, val & 1);
-      val >>= 1;
-    } else {
-      digitalWrite(dataPin, (val & 128) != 0);
-      val <<= 1;
-    }
-
-    digitalWrite(clockPin, HIGH);
-    digitalWrite(clockPin, LOW);
+  FastPin data(dataPin);
+  FastPin clock(clockPin);
+  if (buf == nullptr || !data.is_valid() || !clock.is_valid()) {
+    return;
+  }
+  uint32_t delay_cycles = get_shift_delay_cycles();
+  for (size_t i = 0; i < len; i++) {
+    shift_out_byte(data, clock, bitOrder, buf[i], delay_cycles);
   }
 }
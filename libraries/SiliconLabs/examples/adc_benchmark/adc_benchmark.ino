@@ -0,0 +1,63 @@
+/*
+   ADC benchmark
+
+   The example measures the analogRead() throughput when reading the same pin
+   repeatedly and when alternating between two pins.
+   The ADC keeps its configuration between reads and a pin switch only
+   reconfigures the input multiplexer and the analog bus, so alternating
+   between pins is nearly as fast as reading a single pin. Switching between
+   two voltage references is also cached in the ADC's configuration slots.
+
+   The sketch prints the elapsed time and the achieved read rates to Serial.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+static const uint32_t read_count = 10000u;
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("ADC benchmark");
+}
+
+void loop()
+{
+  uint32_t start_time = micros();
+  for (uint32_t i = 0; i < read_count; i++) {
+    (void)analogRead(A0);
+    (void)analogRead(A0);
+  }
+  uint32_t single_pin_time = micros() - start_time;
+
+  start_time = micros();
+  for (uint32_t i = 0; i < read_count; i++) {
+    (void)analogRead(A0);
+    (void)analogRead(A1);
+  }
+  uint32_t alternating_pin_time = micros() - start_time;
+
+  start_time = micros();
+  for (uint32_t i = 0; i < read_count; i++) {
+    analogReference(AR_VDD);
+    (void)analogRead(A0);
+    analogReference(AR_INTERNAL1V2);
+    (void)analogRead(A0);
+  }
+  uint32_t alternating_reference_time = micros() - start_time;
+  analogReference(AR_VDD);
+
+  print_result("Same pin", single_pin_time);
+  print_result("Alternating pins", alternating_pin_time);
+  print_result("Alternating refs", alternating_reference_time);
+  Serial.println();
+
+  delay(2000);
+}
+
+void print_result(const char* name, uint32_t elapsed_us)
+{
+  // Each iteration performs two reads
+  uint32_t reads_per_sec = (uint32_t)((uint64_t)read_count * 2u * 1000000u / elapsed_us);
+  Serial.printf("%-20s %8lu us  %8lu reads/s\n", name, elapsed_us, reads_per_sec);
+}
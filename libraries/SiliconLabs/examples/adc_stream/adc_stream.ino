@@ -0,0 +1,70 @@
+/*
+   ADC stream
+
+   The example continuously samples A0 at 10 kHz without CPU involvement.
+   The ADC's own timer triggers the conversions and the LDMA moves the results
+   into a double buffer. Every time one half of the buffer is filled the
+   callback receives it from the Arduino task while the other half is being
+   filled in the background.
+
+   The sketch prints the minimum, maximum and average of each block of samples
+   to Serial, along with the number of blocks which weren't processed in time.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+#define SAMPLE_RATE_HZ    10000u
+#define STREAM_BUFFER_LEN 2000u
+
+uint32_t stream_buffer[STREAM_BUFFER_LEN];
+volatile uint32_t block_min;
+volatile uint32_t block_max;
+volatile uint32_t block_avg;
+volatile bool block_ready = false;
+
+void on_samples(const uint32_t* samples, uint32_t num_samples)
+{
+  uint32_t min_value = UINT32_MAX;
+  uint32_t max_value = 0u;
+  uint32_t sum = 0u;
+  for (uint32_t i = 0u; i < num_samples; i++) {
+    uint32_t sample = samples[i];
+    if (sample < min_value) {
+      min_value = sample;
+    }
+    if (sample > max_value) {
+      max_value = sample;
+    }
+    sum += sample;
+  }
+  block_min = min_value;
+  block_max = max_value;
+  block_avg = sum / num_samples;
+  block_ready = true;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("ADC stream");
+
+  if (!ADC.stream_start(pinToPinName(A0), SAMPLE_RATE_HZ, stream_buffer, STREAM_BUFFER_LEN, on_samples)) {
+    Serial.println("Failed to start the ADC stream");
+  }
+}
+
+void loop()
+{
+  if (!block_ready) {
+    return;
+  }
+  block_ready = false;
+  Serial.print("min: ");
+  Serial.print(block_min);
+  Serial.print(" max: ");
+  Serial.print(block_max);
+  Serial.print(" avg: ");
+  Serial.print(block_avg);
+  Serial.print(" overruns: ");
+  Serial.println(ADC.get_stream_overrun_count());
+}
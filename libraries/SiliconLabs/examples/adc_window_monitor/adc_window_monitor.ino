@@ -0,0 +1,54 @@
+/*
+   ADC window monitor
+
+   The example watches the voltage on A0 with the window comparator of the ADC.
+   The conversions are triggered by a low power timer ten times a second and
+   run without waking up the CPU - even in the EM2 low power mode. The CPU is
+   only woken up when the measured value leaves the window between the two
+   thresholds or returns into it.
+
+   The sketch prints every window crossing to Serial. Connect a potentiometer
+   to A0 and turn it to cross the thresholds.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+#define LOW_THRESHOLD   1000u
+#define HIGH_THRESHOLD  3000u
+#define SAMPLE_RATE_HZ  10u
+
+volatile bool crossing_detected = false;
+volatile uint16_t crossing_sample = 0u;
+volatile bool crossing_in_window = true;
+
+// Called from interrupt context on each window crossing
+void on_window_crossing(uint16_t sample, bool in_window)
+{
+  crossing_sample = sample;
+  crossing_in_window = in_window;
+  crossing_detected = true;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("ADC window monitor");
+
+  if (!ADC.window_monitor_start(pinToPinName(A0), LOW_THRESHOLD, HIGH_THRESHOLD, SAMPLE_RATE_HZ, on_window_crossing)) {
+    Serial.println("Failed to start the window monitor");
+  }
+}
+
+void loop()
+{
+  if (crossing_detected) {
+    crossing_detected = false;
+    if (crossing_in_window) {
+      Serial.print("Back in the window: ");
+    } else {
+      Serial.print("Left the window: ");
+    }
+    Serial.println(crossing_sample);
+  }
+  delay(10);
+}
@@ -0,0 +1,52 @@
+/*
+   Analog read async
+
+   The example measures A0 without blocking the sketch while the conversion runs.
+   analogReadAsync() starts the conversion and returns immediately - the result
+   is captured by the ADC interrupt when the conversion completes.
+
+   The first measurement polls for the result and counts how many times the
+   sketch could do other work (like SPI or I2C transfers) in the meantime.
+   The second measurement hands the result to a callback which is called after
+   loop() returns. The results are printed to Serial.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+volatile int callback_result = -1;
+
+void on_analog_read(uint16_t sample)
+{
+  callback_result = sample;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("Analog read async");
+}
+
+void loop()
+{
+  if (callback_result >= 0) {
+    Serial.print("Callback result: ");
+    Serial.println(callback_result);
+    callback_result = -1;
+  }
+
+  // Start a measurement and do other work until the result is ready
+  if (analogReadAsync(A0)) {
+    uint32_t work_count = 0u;
+    while (!analogReadAsyncReady()) {
+      work_count++;
+    }
+    Serial.print("Polled result: ");
+    Serial.print(analogReadAsyncResult());
+    Serial.print(" - loop iterations while converting: ");
+    Serial.println(work_count);
+  }
+
+  // Start a measurement and let the callback receive the result after loop() returns
+  analogReadAsync(A0, on_analog_read);
+  delay(1000);
+}
@@ -0,0 +1,58 @@
+/*
+   Button debouncer
+
+   The example shows how to use the core's debouncer service to handle buttons.
+   The debouncer samples all registered buttons from a low power timer and delivers
+   clean press, release and long press events - no debouncing code is needed in the sketch
+   and short presses aren't missed even if loop() is busy.
+
+   The events of the built-in button (or D2 if the board doesn't have one) and D3 are printed
+   to Serial. Connect a button between D3 and GND to try it with more than one button.
+   The built-in LED is on while the first button is pressed.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+#ifdef BTN_BUILTIN
+static const pin_size_t first_button = BTN_BUILTIN;
+#else
+static const pin_size_t first_button = D2;
+#endif
+
+void on_button_event(const button_event_t& event)
+{
+  switch (event.type) {
+    case BUTTON_PRESSED:
+      Serial.print("Pressed: ");
+      break;
+    case BUTTON_RELEASED:
+      Serial.print("Released: ");
+      break;
+    case BUTTON_LONG_PRESSED:
+      Serial.print("Long pressed: ");
+      break;
+  }
+  Serial.print((uint32_t)event.pin);
+  Serial.print(" at ");
+  Serial.print(event.timestamp);
+  Serial.println(" ms");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("Button debouncer");
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  Debouncer.add_button(first_button, LOW);
+  Debouncer.add_button(D3, LOW);
+  Debouncer.set_long_press_time(1000);
+  Debouncer.set_callback(on_button_event);
+}
+
+void loop()
+{
+  digitalWrite(LED_BUILTIN, Debouncer.is_pressed(first_button) ? HIGH : LOW);
+  // Simulate a busy loop - button events are still captured
+  delay(200);
+}
@@ -0,0 +1,53 @@
+/*
+   DAC waveform generator
+
+   The example generates a sine wave and a triangle wave on the two channels of
+   the board's first DAC without any CPU involvement.
+   One period of each waveform is generated into a table, which is then played
+   in a loop by the LDMA at a fixed sample rate set by the DAC's internal timer.
+   Unlike stepping the output from loop(), the waveforms are not affected by
+   what the sketch is doing.
+
+   The DAC outputs on the MG24 based boards are PB00 and PB01 for channel 0 and 1.
+   Connect an oscilloscope to them to see the waveforms.
+
+   Compatible boards:
+   - Arduino Nano Matter
+   - SparkFun Thing Plus MGM240P
+   - xG24 Explorer Kit
+   - xG24 Dev Kit
+   - Ezurio Lyra 24P 20dBm Dev Kit
+ */
+
+#define SAMPLES_PER_PERIOD  64u
+#define WAVEFORM_FREQ_HZ    100u
+
+uint16_t sine_table[SAMPLES_PER_PERIOD];
+uint16_t triangle_table[SAMPLES_PER_PERIOD];
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("DAC waveform generator");
+  // Select the 1.25V reference voltage (feel free to change it)
+  analogReferenceDAC(DAC_VREF_1V25);
+
+  DacClass::generate_waveform(DAC_WAVEFORM_SINE, sine_table, SAMPLES_PER_PERIOD);
+  DacClass::generate_waveform(DAC_WAVEFORM_TRIANGLE, triangle_table, SAMPLES_PER_PERIOD);
+
+  uint32_t sample_rate = SAMPLES_PER_PERIOD * WAVEFORM_FREQ_HZ;
+  if (!DAC_0.play_waveform(0, sine_table, SAMPLES_PER_PERIOD, sample_rate, true)
+      || !DAC_0.play_waveform(1, triangle_table, SAMPLES_PER_PERIOD, sample_rate, true)) {
+    Serial.println("Failed to start the waveforms");
+    return;
+  }
+  Serial.print("Sample rate: ");
+  Serial.print(DAC_0.get_waveform_sample_rate());
+  Serial.println(" Hz");
+}
+
+void loop()
+{
+  // The waveforms play in the background
+  delay(1000);
+}
@@ -0,0 +1,72 @@
+/*
+   Fast GPIO benchmark
+
+   The example compares the pin toggle rate of the standard digitalWrite() API
+   with the register level FastPin handle and the compile time digitalWrite<pin>() template.
+   The FastPin resolves the pin's GPIO port registers and bit mask once, so each
+   set/clear/toggle afterwards is a single register write.
+   The digitalWrite<pin>() template resolves the pin mapping at compile time.
+
+   The sketch toggles the built-in LED pin a fixed number of times with both methods
+   and prints the achieved toggle rates to Serial. Connect a logic analyzer or
+   an oscilloscope to the pin to see the generated waveform.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+static const uint32_t toggle_count = 100000u;
+
+FastPin fast_led(LED_BUILTIN);
+
+void setup()
+{
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+  Serial.println("Fast GPIO benchmark");
+}
+
+void loop()
+{
+  uint32_t start_time = micros();
+  for (uint32_t i = 0; i < toggle_count; i++) {
+    digitalWrite(LED_BUILTIN, HIGH);
+    digitalWrite(LED_BUILTIN, LOW);
+  }
+  uint32_t digitalwrite_time = micros() - start_time;
+
+  start_time = micros();
+  for (uint32_t i = 0; i < toggle_count; i++) {
+    fast_led.set();
+    fast_led.clear();
+  }
+  uint32_t fastpin_time = micros() - start_time;
+
+  start_time = micros();
+  for (uint32_t i = 0; i < toggle_count; i++) {
+    fast_led.toggle();
+    fast_led.toggle();
+  }
+  uint32_t fastpin_toggle_time = micros() - start_time;
+
+  start_time = micros();
+  for (uint32_t i = 0; i < toggle_count; i++) {
+    digitalWrite<LED_BUILTIN>(HIGH);
+    digitalWrite<LED_BUILTIN>(LOW);
+  }
+  uint32_t template_time = micros() - start_time;
+
+  print_result("digitalWrite()", digitalwrite_time);
+  print_result("FastPin set/clear", fastpin_time);
+  print_result("FastPin toggle", fastpin_toggle_time);
+  print_result("digitalWrite<pin>()", template_time);
+  Serial.println();
+
+  delay(2000);
+}
+
+void print_result(const char* name, uint32_t elapsed_us)
+{
+  // Each iteration produces two edges - one full period
+  uint32_t periods_per_sec = (uint32_t)((uint64_t)toggle_count * 1000000u / elapsed_us);
+  Serial.printf("%-20s %8lu us  %8lu Hz\n", name, elapsed_us, periods_per_sec);
+}
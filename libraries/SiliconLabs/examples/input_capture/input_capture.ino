@@ -0,0 +1,52 @@
+/*
+   Input capture
+
+   The example measures the high time, low time and period of a signal with
+   hardware input capture. The edges of the pin are timestamped by a TIMER at
+   the HF clock resolution, so the measurement is accurate to a fraction of a
+   microsecond and doesn't depend on how often loop() runs.
+
+   The sketch generates a PWM signal on D2 with analogWrite() - connect D2 to D3
+   with a jumper wire to measure it. The results are printed to Serial.
+   pulseIn() also uses hardware input capture when a TIMER is available.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+InputCapture capture;
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("Input capture");
+
+  pinMode(D3, INPUT);
+  analogWrite(D2, 64);
+
+  if (!capture.begin(D3)) {
+    Serial.println("No free TIMER for input capture");
+  }
+}
+
+void loop()
+{
+  uint32_t high_ticks;
+  uint32_t low_ticks;
+  uint32_t period_ticks;
+  if (capture.read_pulse_ticks(HIGH, high_ticks)
+      && capture.read_pulse_ticks(LOW, low_ticks)
+      && capture.read_period_ticks(period_ticks)) {
+    Serial.print("High: ");
+    Serial.print((uint32_t)capture.ticks_to_ns(high_ticks));
+    Serial.print(" ns, low: ");
+    Serial.print((uint32_t)capture.ticks_to_ns(low_ticks));
+    Serial.print(" ns, period: ");
+    Serial.print((uint32_t)capture.ticks_to_ns(period_ticks));
+    Serial.println(" ns");
+  }
+
+  Serial.print("pulseIn(HIGH) on D3: ");
+  Serial.print(pulseIn(D3, HIGH, 100000));
+  Serial.println(" us");
+  delay(1000);
+}
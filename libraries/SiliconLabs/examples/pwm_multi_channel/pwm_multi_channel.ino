@@ -0,0 +1,52 @@
+/*
+   PWM multi channel
+
+   The example drives six PWM outputs at the same time - four channels of an
+   RGBW LED strip on D0-D3 and two fans on D4 and D5.
+   The PWM channels are spread across the TIMER peripherals, each TIMER drives
+   up to three channels at the same frequency. The LED channels run at the
+   default analogWrite() frequency while the fans are moved to a TIMER running
+   at 25 kHz - changing their frequency doesn't affect the LED channels.
+
+   The LED channels fade in and out with a phase shift, the fan speeds ramp up
+   and down slowly.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+const pin_size_t led_pins[] = { D0, D1, D2, D3 };
+const pin_size_t fan_pins[] = { D4, D5 };
+const int fan_pwm_frequency = 25000;
+
+uint8_t brightness = 0u;
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("PWM multi channel");
+
+  // Start the fans at half speed and move them to the fan PWM frequency
+  for (pin_size_t fan_pin : fan_pins) {
+    analogWrite(fan_pin, 128);
+    PWM.duty_cycle_mode_set_frequency(pinToPinName(fan_pin), fan_pwm_frequency);
+  }
+}
+
+void loop()
+{
+  for (uint8_t i = 0; i < 4; i++) {
+    uint8_t phase = brightness + i * 64u;
+    // Triangle wave from the phase
+    uint8_t duty_cycle = (phase < 128u) ? (phase * 2u) : ((255u - phase) * 2u);
+    analogWrite(led_pins[i], duty_cycle);
+  }
+
+  // Ramp the fans between 25% and 100% speed
+  uint8_t fan_duty_cycle = 64u + (brightness * 3u) / 4u;
+  for (pin_size_t fan_pin : fan_pins) {
+    analogWrite(fan_pin, fan_duty_cycle);
+  }
+
+  brightness++;
+  delay(20);
+}
@@ -0,0 +1,36 @@
+/*
+   PWM sequence
+
+   The example makes the built-in LED breathe without any CPU involvement.
+   A gamma corrected breathing sequence is generated once into a buffer, then
+   the LDMA feeds it to the PWM channel - one value in each PWM period.
+   The sketch is free to do anything (even block for a long time) while the
+   LED keeps breathing smoothly.
+
+   With the default 1 kHz PWM frequency a sequence of 2000 values lasts 2 seconds.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+#define SEQUENCE_LENGTH 2000u
+
+uint16_t breathe_sequence[SEQUENCE_LENGTH];
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("PWM sequence");
+
+  PinName led_pin = pinToPinName(LED_BUILTIN);
+  if (!PWM.generate_sequence(led_pin, PWM_SEQUENCE_BREATHE, breathe_sequence, SEQUENCE_LENGTH, true)
+      || !PWM.play_sequence(led_pin, breathe_sequence, SEQUENCE_LENGTH, true)) {
+    Serial.println("Failed to start the PWM sequence");
+  }
+}
+
+void loop()
+{
+  // The LED keeps breathing even while the sketch is blocked
+  Serial.println("Busy for 5 seconds...");
+  delay(5000);
+}
@@ -0,0 +1,56 @@
+/*
+   Tone melody
+
+   The example plays a short melody on a piezo buzzer in the background.
+   The notes are queued with playMelody() - a timer switches to the next note
+   and silences the buzzer after the last one, so the sketch keeps running
+   while the melody is playing. The built-in LED blinks during playback.
+
+   Connect a piezo buzzer to D2 and GND.
+
+   This example is compatible with all Silicon Labs Arduino boards.
+ */
+
+#define BUZZER_PIN D2
+
+#define NOTE_C5 523
+#define NOTE_D5 587
+#define NOTE_E5 659
+#define NOTE_F5 698
+#define NOTE_G5 784
+#define REST    0
+
+const tone_note_t melody[] = {
+  { NOTE_C5, 200 }, { NOTE_D5, 200 }, { NOTE_E5, 200 }, { NOTE_F5, 200 },
+  { NOTE_G5, 400 }, { REST, 100 }, { NOTE_G5, 400 }, { REST, 300 },
+  { NOTE_F5, 200 }, { NOTE_E5, 200 }, { NOTE_D5, 200 }, { NOTE_C5, 600 }
+};
+const size_t melody_length = sizeof(melody) / sizeof(melody[0]);
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("Tone melody");
+  pinMode(LED_BUILTIN, OUTPUT);
+}
+
+void loop()
+{
+  if (playMelody(BUZZER_PIN, melody, melody_length) != melody_length) {
+    Serial.println("Failed to queue the melody");
+  }
+
+  // The sketch is free to run while the melody is playing
+  PinStatus led_state = LED_BUILTIN_ACTIVE;
+  while (isTonePlaying()) {
+    digitalWrite(LED_BUILTIN, led_state);
+    led_state = (led_state == HIGH) ? LOW : HIGH;
+    delay(100);
+  }
+  digitalWrite(LED_BUILTIN, (LED_BUILTIN_ACTIVE == HIGH) ? LOW : HIGH);
+
+  // A single note with a duration doesn't block either
+  tone(BUZZER_PIN, NOTE_C5, 100);
+  Serial.println("Melody finished");
+  delay(2000);
+}
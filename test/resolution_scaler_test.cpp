@@ -0,0 +1,79 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Host test for ResolutionScaler - compares scale() with Arduino's map() for
+// every input value of every supported input resolution
+// Build and run: c++ -std=c++17 -I../cores/silabs resolution_scaler_test.cpp -o resolution_scaler_test && ./resolution_scaler_test
+
+#include <cstdio>
+#include <cstdint>
+#include "resolution_scaler.h"
+
+using namespace arduino;
+
+// The same integer math as map() in the Arduino API - in 64 bits, so the reference doesn't overflow for 16 bit ranges
+static int64_t arduino_map(int64_t x, int64_t in_min, int64_t in_max, int64_t out_min, int64_t out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+static const uint32_t output_maxes[] = {
+  1u, 3u, 7u, 15u, 31u, 63u, 127u, 255u, 511u, 1000u, 1023u, 2047u, 4095u, 8191u, 16383u, 32767u, 65535u
+};
+
+int main()
+{
+  unsigned long mismatches = 0u;
+  unsigned long checked = 0u;
+
+  for (uint32_t output_max : output_maxes) {
+    ResolutionScaler scaler(1u, output_max);
+    for (uint8_t resolution = 1u; resolution <= 16u; resolution++) {
+      scaler.set_input_resolution(resolution);
+      uint32_t input_max = scaler.get_input_max();
+      if (input_max != (1u << resolution) - 1u) {
+        printf("FAIL: input max %lu for %u bits\n", (unsigned long)input_max, resolution);
+        mismatches++;
+        continue;
+      }
+      for (uint32_t value = 0u; value <= input_max; value++) {
+        int64_t expected = arduino_map(value, 0, input_max, 0, output_max);
+        uint32_t result = scaler.scale(value);
+        checked++;
+        if ((int64_t)result != expected) {
+          if (mismatches < 20u) {
+            printf("FAIL: %u bits -> %lu: scale(%lu) = %lu, map() = %lld\n",
+                   resolution, (unsigned long)output_max, (unsigned long)value, (unsigned long)result, (long long)expected);
+          }
+          mismatches++;
+        }
+      }
+    }
+  }
+
+  printf("%lu values checked, %lu mismatches\n", checked, mismatches);
+  return (mismatches == 0u) ? 0 : 1;
+}
@@ -107,12 +107,21 @@ nano_matter_matter = [
     ["nano_matter", "matter"],
 ]
 
+# Host tests - built with the host C++ compiler and run right away
+host_tests = [
+    "resolution_scaler_test.cpp",
+]
+
 testlist_quick = {
     "test_sketch/test_sketch.ino":                                                                                  all_variants,
 }
 
 testlist_ble = {
     # Silicon Labs example library
+    "../libraries/SiliconLabs/examples/adc_benchmark/adc_benchmark.ino":                                            all_variants,
+    "../libraries/SiliconLabs/examples/adc_stream/adc_stream.ino":                                                  all_variants,
+    "../libraries/SiliconLabs/examples/adc_window_monitor/adc_window_monitor.ino":                                  all_variants,
+    "../libraries/SiliconLabs/examples/analog_read_async/analog_read_async.ino":                                    all_variants,
     "../libraries/SiliconLabs/examples/ble_blinky/ble_blinky.ino":                                                  all_ble_silabs,
     "../libraries/SiliconLabs/examples/ble_health_thermometer/ble_health_thermometer.ino":                          all_ble_silabs,
     "../libraries/SiliconLabs/examples/ble_health_thermometer_client/ble_health_thermometer_client.ino":            all_ble_silabs,
@@ -122,7 +131,14 @@ testlist_ble = {
     "../libraries/SiliconLabs/examples/ble_minimal/ble_minimal.ino":                                                all_ble_silabs,
     "../libraries/SiliconLabs/examples/ble_thingplus_battery_gauge/ble_thingplus_battery_gauge.ino":                thingplusmatter_ble_silabs,
     "../libraries/SiliconLabs/examples/ble_xg27_devkit_sensors/ble_xg27_devkit_sensors.ino":                        xg27devkit_ble_silabs,
+    "../libraries/SiliconLabs/examples/button_debouncer/button_debouncer.ino":                                      all_variants,
     "../libraries/SiliconLabs/examples/dac_sawtooth/dac_sawtooth.ino":                                              boards_with_dac,
+    "../libraries/SiliconLabs/examples/dac_waveform/dac_waveform.ino":                                              boards_with_dac,
+    "../libraries/SiliconLabs/examples/fast_gpio_benchmark/fast_gpio_benchmark.ino":                                all_variants,
+    "../libraries/SiliconLabs/examples/input_capture/input_capture.ino":                                            all_variants,
+    "../libraries/SiliconLabs/examples/pwm_multi_channel/pwm_multi_channel.ino":                                    all_variants,
+    "../libraries/SiliconLabs/examples/pwm_sequence/pwm_sequence.ino":                                              all_variants,
+    "../libraries/SiliconLabs/examples/tone_melody/tone_melody.ino":                                                all_variants,
     "../libraries/SiliconLabs/examples/xg27devkit_sensors/xg27devkit_sensors.ino":                                  xg27devkit_ble_silabs,
     "../libraries/SiliconLabs/examples/thingplusmatter_debug_unix/thingplusmatter_debug_unix.ino":                  all_ble_silabs,
     "../libraries/SiliconLabs/examples/thingplusmatter_debug_win/thingplusmatter_debug_win.ino":                    all_ble_silabs,
@@ -185,6 +201,11 @@ def main():
     signal.signal(signal.SIGINT, sigint_handler)
 
     test_config = get_config_from_arguments()
+    host_tests_passed = True
+    if test_config == "host" or test_config == "all":
+        host_tests_passed = run_host_tests()
+        if test_config == "host":
+            exit(0 if host_tests_passed else 200)
     testlist = testlist_quick
     if test_config == "quick":
         testlist = testlist_quick
@@ -244,10 +265,29 @@ def main():
         for failedvar in failed_build_names:
             print(failedvar)
     # If we had errors or warnings exit with a different code
-    if failed_builds != 0 or len(builds_with_warnings) != 0:
+    if not host_tests_passed:
+        print("Host tests failed!")
+    if failed_builds != 0 or len(builds_with_warnings) != 0 or not host_tests_passed:
         exit(200)
 
 
+def run_host_tests():
+    """
+    Builds and runs the host tests with the host C++ compiler
+    """
+    all_passed = True
+    for test_source in host_tests:
+        test_binary = "./" + test_source.replace(".cpp", "")
+        print("-"*40)
+        print(f"Running host test '{test_source}'")
+        print("-"*40)
+        build_result = subprocess.run(["c++", "-std=c++17", "-Wall", "-Wextra", "-O2", "-I../cores/silabs", test_source, "-o", test_binary])
+        if build_result.returncode != 0 or subprocess.run([test_binary]).returncode != 0:
+            print("Host test failed!")
+            all_passed = False
+    return all_passed
+
+
 def arduino_cli_build(board, protocol_stack, sketch_path, build_num, testcase_count):
     """
     Builds the specified sketch for the specified variant with Arduino CLI
@@ -313,6 +353,9 @@ def get_config_from_arguments():
     elif input_config_name == "matter":
         print("Running Matter tests only")
         return "matter"
+    elif input_config_name == "host":
+        print("Running host tests only")
+        return "host"
     return "all"
 
 
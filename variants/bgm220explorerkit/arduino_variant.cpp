@@ -60,31 +60,12 @@ void init_arduino_variant()
   SPIDRV_DeInit(SL_SPIDRV_PERIPHERAL_HANDLE); //SPI.end();
 }
 
-// Variant pin mapping - maps Arduino pin numbers to Silabs ports/pins
-// D0 -> Dmax -> A0 -> Amax -> Other peripherals
-PinName gPinNames[] = {
-  PA0, // D0
-  PC0, // D1 - SPI SDO - WU
-  PC1, // D2 - SPI SDI
-  PC2, // D3 - SPI SCK
-  PC3, // D4 - SPI CS
-  PC6, // D5
-  PB0, // D6
-  PC7, // A0 - WU
-  PA4, // A1
-  PD3, // A2 - SDA
-  PD2, // A3 - SCL - WU
-  PB1, // A4 - Tx1 - WU - 11
-  PB2, // A5 - Rx1 - 12
-  PB3, // A6 - WU
-  PB4, // A7
-  PA4, // LED - 15
-  PC7, // Button - 16
-  PA6, // Rx - 17
-  PA5, // Tx - WU - 18
-};
+#if __cplusplus < 201703L
+// Before C++17 the static constexpr member needs a definition outside of the class
+constexpr PinName ArduinoVariantPins::names[];
+#endif
 
 unsigned int getPinCount()
 {
-  return sizeof(gPinNames) / sizeof(gPinNames[0]);
+  return sizeof(ArduinoVariantPins::names) / sizeof(ArduinoVariantPins::names[0]);
 }
@@ -29,7 +29,33 @@
 
 #include "pinDefinitions.h"
 
-extern PinName gPinNames[];
+// Variant pin mapping - maps Arduino pin numbers to Silabs ports/pins
+// D0 -> Dmax -> A0 -> Amax -> Other peripherals
+// A static constexpr member has one definition shared by all translation units (in arduino_variant.cpp)
+// and can still be used at compile time by the templates in fast_gpio.h
+struct ArduinoVariantPins {
+  static constexpr PinName names[] = {
+    PA0, // D0
+    PC0, // D1 - SPI SDO - WU
+    PC1, // D2 - SPI SDI
+    PC2, // D3 - SPI SCK
+    PC3, // D4 - SPI CS
+    PC6, // D5
+    PB0, // D6
+    PC7, // A0 - WU
+    PA4, // A1
+    PD3, // A2 - SDA
+    PD2, // A3 - SCL - WU
+    PB1, // A4 - Tx1 - WU - 11
+    PB2, // A5 - Rx1 - 12
+    PB3, // A6 - WU
+    PB4, // A7
+    PA4, // LED - 15
+    PC7, // Button - 16
+    PA6, // Rx - 17
+    PA5, // Tx - WU - 18
+  };
+};
 
 unsigned int getPinCount();
 
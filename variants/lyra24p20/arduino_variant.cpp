@@ -68,31 +68,12 @@ void init_arduino_variant()
   SPIDRV_DeInit(SL_SPIDRV1_PERIPHERAL_HANDLE); // SPI1.end();
 }
 
-// Variant pin mapping - maps Arduino pin numbers to Silabs ports/pins
-// D0 -> Dmax -> A0 -> Amax -> Other peripherals
-PinName gPinNames[] = {
-  PA4, // D0
-  PA5, // D1 - WU
-  PC4, // D2 - SPI SDO
-  PC5, // D3 - SPI SDI - WU
-  PC2, // D4 - SPI SCK
-  PC3, // D5 - SPI CS
-  PC6, // D6 - SPI1 SS
-  PB0, // D7 - SPI1 SCK - DAC0
-  PA6, // A0 - 8
-  PA8, // A1 - LED - 9
-  PD3, // A2 - SDA - 10
-  PD2, // A3 - SCL - WU - 11
-  PB1, // A4 - Tx - DAC1 - WU - 12
-  PB2, // A5 - Rx - DAC2 - 13
-  PB3, // A6 - SPI1 SDO - Tx1 - DAC3 - WU - 14
-  PB4, // A7 - SPI1 SDI - Rx1 - 15
-  PC7, // Button - WU - 16
-  PA0, // Rx - 17
-  PA7  // Tx - 18
-};
+#if __cplusplus < 201703L
+// Before C++17 the static constexpr member needs a definition outside of the class
+constexpr PinName ArduinoVariantPins::names[];
+#endif
 
 unsigned int getPinCount()
 {
-  return sizeof(gPinNames) / sizeof(gPinNames[0]);
+  return sizeof(ArduinoVariantPins::names) / sizeof(ArduinoVariantPins::names[0]);
 }
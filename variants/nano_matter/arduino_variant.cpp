@@ -118,40 +118,12 @@ void init_arduino_variant()
   SPIDRV_DeInit(SL_SPIDRV1_PERIPHERAL_HANDLE); // SPI1.end();
 }
 
-// Variant pin mapping - maps Arduino pin numbers to Silabs ports/pins
-// D0 -> Dmax -> A0 -> Amax -> Other peripherals
-PinName gPinNames[] = {
-  PA4, // D0 - Tx1 - SPI1 SDO
-  PA5, // D1 - Rx1 - SPI1 SDI - WU
-  PA3, // D2 - SPI1 SCK
-  PC6, // D3 - SPI1 SS
-  PC7, // D4 - SDA1 - WU
-  PC8, // D5 - SCL1
-  PC9, // D6
-  PD2, // D7 - WU
-  PD3, // D8
-  PD4, // D9
-  PD5, // D10 - SPI SS
-  PA9, // D11 - SPI SDO
-  PA8, // D12 - SPI SDI
-  PB4, // D13 - SPI SCK
-  PB0, // A0 - DAC0
-  PB2, // A1 - DAC2
-  PB5, // A2
-  PC0, // A3 - WU
-  PA6, // A4 - SDA
-  PA7, // A5 - SCL
-  PB1, // A6 - DAC1 - WU
-  PB3, // A7 - DAC3 - WU
-  PC1, // LED R - 22
-  PC2, // LED G - 23
-  PC3, // LED B - 24
-  PA0, // Button - 25
-  PC4, // Serial Tx - 26
-  PC5, // Serial Rx - WU - 27
-};
+#if __cplusplus < 201703L
+// Before C++17 the static constexpr member needs a definition outside of the class
+constexpr PinName ArduinoVariantPins::names[];
+#endif
 
 unsigned int getPinCount()
 {
-  return sizeof(gPinNames) / sizeof(gPinNames[0]);
+  return sizeof(ArduinoVariantPins::names) / sizeof(ArduinoVariantPins::names[0]);
 }
@@ -30,7 +30,42 @@
 #include "Arduino.h"
 #include "pinDefinitions.h"
 
-extern PinName gPinNames[];
+// Variant pin mapping - maps Arduino pin numbers to Silabs ports/pins
+// D0 -> Dmax -> A0 -> Amax -> Other peripherals
+// A static constexpr member has one definition shared by all translation units (in arduino_variant.cpp)
+// and can still be used at compile time by the templates in fast_gpio.h
+struct ArduinoVariantPins {
+  static constexpr PinName names[] = {
+    PA4, // D0 - Tx1 - SPI1 SDO
+    PA5, // D1 - Rx1 - SPI1 SDI - WU
+    PA3, // D2 - SPI1 SCK
+    PC6, // D3 - SPI1 SS
+    PC7, // D4 - SDA1 - WU
+    PC8, // D5 - SCL1
+    PC9, // D6
+    PD2, // D7 - WU
+    PD3, // D8
+    PD4, // D9
+    PD5, // D10 - SPI SS
+    PA9, // D11 - SPI SDO
+    PA8, // D12 - SPI SDI
+    PB4, // D13 - SPI SCK
+    PB0, // A0 - DAC0
+    PB2, // A1 - DAC2
+    PB5, // A2
+    PC0, // A3 - WU
+    PA6, // A4 - SDA
+    PA7, // A5 - SCL
+    PB1, // A6 - DAC1 - WU
+    PB3, // A7 - DAC3 - WU
+    PC1, // LED R - 22
+    PC2, // LED G - 23
+    PC3, // LED B - 24
+    PA0, // Button - 25
+    PC4, // Serial Tx - 26
+    PC5, // Serial Rx - WU - 27
+  };
+};
 
 unsigned int getPinCount();
 
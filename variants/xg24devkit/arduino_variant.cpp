@@ -109,35 +109,12 @@ void init_arduino_variant()
   SPIDRV_DeInit(SL_SPIDRV_PERIPHERAL_HANDLE); //SPI.end();
 }
 
-// Variant pin mapping - maps Arduino pin numbers to Silabs ports/pins
-// D0 -> Dmax -> A0 -> Amax -> Other peripherals
-PinName gPinNames[] = {
-  PC3, // D0 - SPI SDO
-  PC2, // D1 - SPI SDI
-  PC1, // D2 - SPI SCK
-  PA7, // D3 - SPI CS
-  PA5, // D4 - Tx - WU
-  PA6, // D5 - Rx
-  PC5, // D6 - SDA - WU
-  PB2, // A0 - DAC2
-  PB0, // A1 - DAC0
-  PB3, // A2 - DAC3
-  PD2, // A3 - WU
-  PC4, // A4 - SCL
-  PD2, // LED R - 12
-  PA4, // LED G - 13
-  PB0, // LED B - 14
-  PB2, // Button - DAC2 - 15
-  PB3, // Button - DAC3 - WU - 16
-  PC9, // Sensor array power - 17
-  PC8, // Microphone power - 18
-  PC0, // SPI flash CS - WU - 19
-  PD3, // I2S SCK - 20
-  PD4, // I2S SD - 21
-  PD5, // I2S WS - WU - 22
-};
+#if __cplusplus < 201703L
+// Before C++17 the static constexpr member needs a definition outside of the class
+constexpr PinName ArduinoVariantPins::names[];
+#endif
 
 unsigned int getPinCount()
 {
-  return sizeof(gPinNames) / sizeof(gPinNames[0]);
+  return sizeof(ArduinoVariantPins::names) / sizeof(ArduinoVariantPins::names[0]);
 }
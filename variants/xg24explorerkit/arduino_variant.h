@@ -29,7 +29,37 @@
 
 #include "pinDefinitions.h"
 
-extern PinName gPinNames[];
+// Variant pin mapping - maps Arduino pin numbers to Silabs ports/pins
+// D0 -> Dmax -> A0 -> Amax -> Other peripherals
+// A static constexpr member has one definition shared by all translation units (in arduino_variant.cpp)
+// and can still be used at compile time by the templates in fast_gpio.h
+struct ArduinoVariantPins {
+  static constexpr PinName names[] = {
+    PC9, // D0
+    PC3, // D1 - SPI SDO
+    PC2, // D2 - SPI SDI
+    PC1, // D3 - SPI SCK
+    PC0, // D4 - SPI CS - WU
+    PC8, // D5 - SPI1 SS
+    PB0, // D6 - SPI1 SCK - DAC0
+    PD2, // A0 - WU
+    PD3, // A1
+    PB5, // A2 - SDA
+    PB4, // A3 - SCL
+    PD4, // A4 - 11
+    PD5, // A5 - 12 - WU
+    PB1, // A6 - SPI1 SDO - Tx1 - DAC1 - WU
+    PA0, // A7 - SPI1 SDI - Rx1
+    PA4, // LED - 15
+    PA7, // LED - 16
+    PB2, // Button - DAC2 - 17
+    PB3, // Button - DAC3 - WU - 18
+    PC4, // SCL1 - 19
+    PC5, // SDA1 - WU - 20
+    PA6, // Rx - 21
+    PA5, // Tx - WU - 22
+  };
+};
 
 unsigned int getPinCount();
 
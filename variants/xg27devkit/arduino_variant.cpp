@@ -60,31 +60,12 @@ void init_arduino_variant()
   SPIDRV_DeInit(SL_SPIDRV_PERIPHERAL_HANDLE); //SPI.end();
 }
 
-// Variant pin mapping - maps Arduino pin numbers to Silabs ports/pins
-// D0 -> Dmax -> A0 -> Amax -> Other peripherals
-PinName gPinNames[] = {
-  PC0, // D0 - SPI SDO - WU
-  PC1, // D1 - SPI SDI
-  PC2, // D2 - SPI SCK
-  PB2, // D3 - SPI CS
-  PA5, // D4 - Tx - WU
-  PA6, // D5 - Rx
-  PD2, // D6 - SDA - WU
-  PA8, // A0 - Tx1
-  PA7, // A1 - Rx1
-  PB0, // A2
-  PB1, // A3 - WU
-  PA4, // A4 - LED
-  PB3, // A5 - Button - WU
-  PD3, // A6 - SCL
-  PA4, // LED - 14
-  PB3, // Button - 15
-  PC6, // Sensor array power - 16
-  PC7, // Microphone power - WU - 17
-  PB4, // IMU power - 18
-};
+#if __cplusplus < 201703L
+// Before C++17 the static constexpr member needs a definition outside of the class
+constexpr PinName ArduinoVariantPins::names[];
+#endif
 
 unsigned int getPinCount()
 {
-  return sizeof(gPinNames) / sizeof(gPinNames[0]);
+  return sizeof(ArduinoVariantPins::names) / sizeof(ArduinoVariantPins::names[0]);
 }